@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <optional>
 
 #include "point2d.hpp"
@@ -8,27 +9,27 @@
 namespace Symphony {
 namespace Math {
 
-const float eps = 0.0001f;
+constexpr float eps = 0.0001f;
 
 class AARect2d {
  public:
-  AARect2d() {}
+  constexpr AARect2d() {}
 
-  AARect2d(const Point2d& new_center, const Vector2d& new_half_size)
+  constexpr AARect2d(const Point2d& new_center, const Vector2d& new_half_size)
       : center(new_center), half_size(new_half_size) {}
 
-  Point2d BottomLeft() const { return center - half_size; }
+  constexpr Point2d BottomLeft() const { return center - half_size; }
 
-  Point2d TopRight() const { return center + half_size; }
+  constexpr Point2d TopRight() const { return center + half_size; }
 
-  bool IsPointInside(const Point2d& p) const {
+  constexpr bool IsPointInside(const Point2d& p) const {
     Point2d bottom_left = BottomLeft();
     Point2d top_right = TopRight();
     return (p.x > bottom_left.x && p.y > bottom_left.y && p.x < top_right.x &&
             p.y < top_right.y);
   }
 
-  bool IsPointOnLeftBorder(const Point2d& p, float eps) const {
+  constexpr bool IsPointOnLeftBorder(const Point2d& p, float eps) const {
     float left = center.x - half_size.x;
     float bottom = center.y - half_size.y;
     float top = center.y + half_size.y;
@@ -36,7 +37,7 @@ class AARect2d {
             p.y > (bottom - eps) && p.y < (top - eps));
   }
 
-  bool IsPointOnRightBorder(const Point2d& p, float eps) const {
+  constexpr bool IsPointOnRightBorder(const Point2d& p, float eps) const {
     float right = center.x + half_size.x;
     float bottom = center.y - half_size.y;
     float top = center.y + half_size.y;
@@ -44,7 +45,7 @@ class AARect2d {
             p.y > (bottom - eps) && p.y < (top - eps));
   }
 
-  bool IsPointOnTopBorder(const Point2d& p, float eps) const {
+  constexpr bool IsPointOnTopBorder(const Point2d& p, float eps) const {
     float left = center.x - half_size.x;
     float right = center.x + half_size.x;
     float top = center.y + half_size.y;
@@ -52,7 +53,7 @@ class AARect2d {
             p.y < (top + eps));
   }
 
-  bool IsPointOnBottomBorder(const Point2d& p, float eps) const {
+  constexpr bool IsPointOnBottomBorder(const Point2d& p, float eps) const {
     float left = center.x - half_size.x;
     float right = center.x + half_size.x;
     float bottom = center.y - half_size.y;
@@ -71,8 +72,37 @@ class AARect2d {
                               const Vector2d& ray_dir_norm,
                               FromInsideIntersection& intersection_out);
 
-  bool Intersect(const AARect2d& rect);
-  std::optional<AARect2d> IntersectRectangle(const AARect2d& rect);
+  bool Intersect(const AARect2d& rect) const;
+  std::optional<AARect2d> IntersectRectangle(const AARect2d& rect) const;
+
+  /// Slab test. \arg distance_out Distance along the ray to the entry point,
+  /// zero when ray_start is inside.
+  bool IntersectRay(const Point2d& ray_start, const Vector2d& ray_dir_norm,
+                    float max_distance, float& distance_out) const;
+
+  constexpr bool Contains(const AARect2d& rect) const {
+    return (rect.center.x - rect.half_size.x >= center.x - half_size.x &&
+            rect.center.x + rect.half_size.x <= center.x + half_size.x &&
+            rect.center.y - rect.half_size.y >= center.y - half_size.y &&
+            rect.center.y + rect.half_size.y <= center.y + half_size.y);
+  }
+
+  constexpr AARect2d GetMerged(const AARect2d& rect) const {
+    float left =
+        std::min(center.x - half_size.x, rect.center.x - rect.half_size.x);
+    float right =
+        std::max(center.x + half_size.x, rect.center.x + rect.half_size.x);
+    float bottom =
+        std::min(center.y - half_size.y, rect.center.y - rect.half_size.y);
+    float top =
+        std::max(center.y + half_size.y, rect.center.y + rect.half_size.y);
+    return AARect2d(Point2d((left + right) * 0.5f, (bottom + top) * 0.5f),
+                    Vector2d((right - left) * 0.5f, (top - bottom) * 0.5f));
+  }
+
+  constexpr float GetPerimeter() const {
+    return 4.0f * (half_size.x + half_size.y);
+  }
 
   Point2d center;
   Vector2d half_size;
@@ -159,8 +189,49 @@ inline void AARect2d::IntersectRayFromInside(
   }
 }
 
+inline bool AARect2d::IntersectRay(const Point2d& ray_start,
+                                   const Vector2d& ray_dir_norm,
+                                   float max_distance,
+                                   float& distance_out) const {
+  float t_min = 0.0f;
+  float t_max = max_distance;
+
+  if (ray_dir_norm.x == 0.0f) {
+    if (fabsf(ray_start.x - center.x) > half_size.x) {
+      return false;
+    }
+  } else {
+    float dir_inv = 1.0f / ray_dir_norm.x;
+    float t1 = (center.x - half_size.x - ray_start.x) * dir_inv;
+    float t2 = (center.x + half_size.x - ray_start.x) * dir_inv;
+    t_min = std::max(t_min, std::min(t1, t2));
+    t_max = std::min(t_max, std::max(t1, t2));
+    if (t_min > t_max) {
+      return false;
+    }
+  }
+
+  if (ray_dir_norm.y == 0.0f) {
+    if (fabsf(ray_start.y - center.y) > half_size.y) {
+      return false;
+    }
+  } else {
+    float dir_inv = 1.0f / ray_dir_norm.y;
+    float t1 = (center.y - half_size.y - ray_start.y) * dir_inv;
+    float t2 = (center.y + half_size.y - ray_start.y) * dir_inv;
+    t_min = std::max(t_min, std::min(t1, t2));
+    t_max = std::min(t_max, std::max(t1, t2));
+    if (t_min > t_max) {
+      return false;
+    }
+  }
+
+  distance_out = t_min;
+  return true;
+}
+
 inline std::optional<AARect2d> AARect2d::IntersectRectangle(
-    const AARect2d& rect) {
+    const AARect2d& rect) const {
   float left = center.x - half_size.x;
   float right = center.x + half_size.x;
   float bottom = center.y - half_size.y;
@@ -192,8 +263,22 @@ inline std::optional<AARect2d> AARect2d::IntersectRectangle(
   return AARect2d({new_center}, new_half_size);
 }
 
-inline bool AARect2d::Intersect(const AARect2d& rect) {
-  return IntersectRectangle(rect).has_value();
+inline bool AARect2d::Intersect(const AARect2d& rect) const {
+  float overlap_x =
+      std::min(center.x + half_size.x, rect.center.x + rect.half_size.x) -
+      std::max(center.x - half_size.x, rect.center.x - rect.half_size.x);
+  if (overlap_x < eps) {
+    return false;
+  }
+
+  float overlap_y =
+      std::min(center.y + half_size.y, rect.center.y + rect.half_size.y) -
+      std::max(center.y - half_size.y, rect.center.y - rect.half_size.y);
+  if (overlap_y < eps) {
+    return false;
+  }
+
+  return true;
 }
 
 }  // namespace Math
@@ -245,4 +245,49 @@ TEST(AARect2d, IntersectRectangle) {
   ASSERT_NEAR(rect1.center.y, intersection1->center.y, eps);
   ASSERT_NEAR(rect1.half_size.x, intersection1->half_size.x, eps);
   ASSERT_NEAR(rect1.half_size.y, intersection1->half_size.y, eps);
-}
\ No newline at end of file
+}
+
+TEST(AARect2d, IntersectRay) {
+  AARect2d rect(Point2d(10.0f, 15.0f),
+                /* new_half_size= */ Vector2d(2.0f, 3.0f));
+
+  float distance = 0.0f;
+  ASSERT_TRUE(rect.IntersectRay(/* ray_start= */ Point2d(0.0f, 15.0f),
+                                /* ray_dir_norm= */ Vector2d(1.0f, 0.0f),
+                                /* max_distance= */ 100.0f, distance));
+  ASSERT_NEAR(8.0f, distance, eps);
+
+  ASSERT_FALSE(rect.IntersectRay(Point2d(0.0f, 15.0f), Vector2d(1.0f, 0.0f),
+                                 /* max_distance= */ 7.0f, distance));
+  ASSERT_FALSE(rect.IntersectRay(Point2d(0.0f, 15.0f), Vector2d(-1.0f, 0.0f),
+                                 100.0f, distance));
+  ASSERT_FALSE(rect.IntersectRay(Point2d(0.0f, 19.0f), Vector2d(1.0f, 0.0f),
+                                 100.0f, distance));
+
+  ASSERT_TRUE(rect.IntersectRay(Point2d(10.0f, 15.0f), Vector2d(0.0f, 1.0f),
+                                100.0f, distance));
+  ASSERT_NEAR(0.0f, distance, eps);
+
+  ASSERT_TRUE(rect.IntersectRay(Point2d(0.0f, 5.0f),
+                                Vector2d(1.0f, 1.0f).GetNormalized(), 100.0f,
+                                distance));
+  ASSERT_NEAR(sqrtf(2.0f) * 8.0f, distance, eps);
+}
+
+TEST(AARect2d, ContainsMerged) {
+  AARect2d rect1(Point2d(0.0f, 0.0f), Vector2d(2.0f, 2.0f));
+  AARect2d rect2(Point2d(5.0f, 1.0f), Vector2d(1.0f, 3.0f));
+  ASSERT_TRUE(rect1.Contains(rect1));
+  ASSERT_TRUE(
+      rect1.Contains(AARect2d(Point2d(1.0f, 1.0f), Vector2d(1.0f, 1.0f))));
+  ASSERT_FALSE(rect1.Contains(rect2));
+
+  AARect2d merged = rect1.GetMerged(rect2);
+  ASSERT_TRUE(merged.Contains(rect1));
+  ASSERT_TRUE(merged.Contains(rect2));
+  ASSERT_NEAR(2.0f, merged.center.x, eps);
+  ASSERT_NEAR(1.0f, merged.center.y, eps);
+  ASSERT_NEAR(4.0f, merged.half_size.x, eps);
+  ASSERT_NEAR(3.0f, merged.half_size.y, eps);
+  ASSERT_NEAR(28.0f, merged.GetPerimeter(), eps);
+}
@@ -0,0 +1,412 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "aa_rect2d.hpp"
+#include "point2d.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Collision {
+// Dynamic bounding volume tree, an alternative to SpatialBin2d for sparse
+// worlds and very uneven object sizes. Leaves store fat rectangles so small
+// moves don't touch the tree. Inserts pick the sibling with the smallest
+// perimeter growth, the tree is kept balanced with AVL rotations.
+template <typename ObjectType>
+class AABBTree2d {
+ public:
+  static const int kNullNode = -1;
+
+  AABBTree2d() {}
+
+  explicit AABBTree2d(float fat_margin) : fat_margin_(fat_margin) {}
+
+  void Clear() {
+    nodes_.clear();
+    root_ = kNullNode;
+    free_list_ = kNullNode;
+  }
+
+  /// Returns proxy id to use with Remove and Move.
+  int Add(const Math::Point2d& center, const Math::Vector2d& half_sizes,
+          const ObjectType& object) {
+    int proxy_id = allocateNode();
+    nodes_[proxy_id].aabb = makeFat(center, half_sizes);
+    nodes_[proxy_id].object = object;
+    insertLeaf(proxy_id);
+    return proxy_id;
+  }
+
+  void Remove(int proxy_id) {
+    removeLeaf(proxy_id);
+    freeNode(proxy_id);
+  }
+
+  /// Returns true when the tree has been changed, false when the new
+  /// rectangle still fits into the fat one.
+  bool Move(int proxy_id, const Math::Point2d& center,
+            const Math::Vector2d& half_sizes) {
+    if (nodes_[proxy_id].aabb.Contains(Math::AARect2d(center, half_sizes))) {
+      return false;
+    }
+
+    removeLeaf(proxy_id);
+    nodes_[proxy_id].aabb = makeFat(center, half_sizes);
+    insertLeaf(proxy_id);
+    return true;
+  }
+
+  const ObjectType& GetObject(int proxy_id) const {
+    return nodes_[proxy_id].object;
+  }
+
+  const Math::AARect2d& GetFatAABB(int proxy_id) const {
+    return nodes_[proxy_id].aabb;
+  }
+
+  void Query(const Math::Point2d& center, const Math::Vector2d& half_sizes,
+             std::vector<ObjectType>& result_out) const {
+    result_out.clear();
+    if (root_ == kNullNode) {
+      return;
+    }
+
+    Math::AARect2d rect(center, half_sizes);
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(root_);
+    while (!stack.empty()) {
+      const Node& node = nodes_[stack.back()];
+      stack.pop_back();
+
+      if (!overlaps(node.aabb, rect)) {
+        continue;
+      }
+
+      if (node.IsLeaf()) {
+        result_out.push_back(node.object);
+      } else {
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+      }
+    }
+  }
+
+  /// \arg callback Called as callback(object) for every leaf the ray reaches,
+  /// returns std::optional<float> distance to the hit. Leaves farther than
+  /// the closest reported hit are skipped.
+  /// Returns the closest reported hit distance.
+  template <typename Callback>
+  std::optional<float> RayCast(const Math::Point2d& ray_start,
+                               const Math::Vector2d& ray_dir_norm,
+                               float max_distance, Callback callback) const {
+    std::optional<float> result;
+    if (root_ == kNullNode) {
+      return result;
+    }
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(root_);
+    while (!stack.empty()) {
+      const Node& node = nodes_[stack.back()];
+      stack.pop_back();
+
+      float distance = 0.0f;
+      if (!node.aabb.IntersectRay(ray_start, ray_dir_norm, max_distance,
+                                  distance)) {
+        continue;
+      }
+
+      if (node.IsLeaf()) {
+        std::optional<float> hit = callback(node.object);
+        if (hit.has_value() && hit.value() <= max_distance) {
+          max_distance = hit.value();
+          result = hit;
+        }
+        continue;
+      }
+
+      // Visit the nearer child first so it clips the farther one.
+      float distance1 = 0.0f;
+      float distance2 = 0.0f;
+      bool hit1 = nodes_[node.child1].aabb.IntersectRay(
+          ray_start, ray_dir_norm, max_distance, distance1);
+      bool hit2 = nodes_[node.child2].aabb.IntersectRay(
+          ray_start, ray_dir_norm, max_distance, distance2);
+      if (hit1 && hit2) {
+        if (distance1 < distance2) {
+          stack.push_back(node.child2);
+          stack.push_back(node.child1);
+        } else {
+          stack.push_back(node.child1);
+          stack.push_back(node.child2);
+        }
+      } else if (hit1) {
+        stack.push_back(node.child1);
+      } else if (hit2) {
+        stack.push_back(node.child2);
+      }
+    }
+
+    return result;
+  }
+
+  int GetHeight() const {
+    if (root_ == kNullNode) {
+      return 0;
+    }
+    return nodes_[root_].height;
+  }
+
+ private:
+  struct Node {
+    bool IsLeaf() const { return child1 == kNullNode; }
+
+    Math::AARect2d aabb;
+    int parent{kNullNode};
+    int child1{kNullNode};
+    int child2{kNullNode};
+    int height{0};
+    ObjectType object{};
+  };
+
+  static bool overlaps(const Math::AARect2d& a, const Math::AARect2d& b) {
+    return (fabsf(a.center.x - b.center.x) <= a.half_size.x + b.half_size.x &&
+            fabsf(a.center.y - b.center.y) <= a.half_size.y + b.half_size.y);
+  }
+
+  Math::AARect2d makeFat(const Math::Point2d& center,
+                         const Math::Vector2d& half_sizes) const {
+    Math::Vector2d margin(fat_margin_, fat_margin_);
+    return Math::AARect2d(center, half_sizes + margin);
+  }
+
+  int allocateNode() {
+    int index = kNullNode;
+    if (free_list_ != kNullNode) {
+      index = free_list_;
+      free_list_ = nodes_[index].parent;
+      nodes_[index] = Node();
+    } else {
+      index = (int)nodes_.size();
+      nodes_.push_back(Node());
+    }
+    return index;
+  }
+
+  void freeNode(int index) {
+    nodes_[index] = Node();
+    nodes_[index].parent = free_list_;
+    nodes_[index].height = -1;
+    free_list_ = index;
+  }
+
+  float insertionCost(int index, const Math::AARect2d& leaf_aabb) const {
+    const Node& node = nodes_[index];
+    float merged_perimeter = node.aabb.GetMerged(leaf_aabb).GetPerimeter();
+    if (node.IsLeaf()) {
+      return merged_perimeter;
+    }
+    return merged_perimeter - node.aabb.GetPerimeter();
+  }
+
+  void insertLeaf(int leaf) {
+    if (root_ == kNullNode) {
+      root_ = leaf;
+      nodes_[root_].parent = kNullNode;
+      return;
+    }
+
+    Math::AARect2d leaf_aabb = nodes_[leaf].aabb;
+
+    int index = root_;
+    while (!nodes_[index].IsLeaf()) {
+      const Node& node = nodes_[index];
+
+      float perimeter = node.aabb.GetPerimeter();
+      float merged_perimeter = node.aabb.GetMerged(leaf_aabb).GetPerimeter();
+
+      // Cost of making a new parent for this node and the leaf.
+      float cost = 2.0f * merged_perimeter;
+      // Minimum cost of pushing the leaf further down the tree.
+      float inheritance_cost = 2.0f * (merged_perimeter - perimeter);
+
+      float cost1 = insertionCost(node.child1, leaf_aabb) + inheritance_cost;
+      float cost2 = insertionCost(node.child2, leaf_aabb) + inheritance_cost;
+      if (cost < cost1 && cost < cost2) {
+        break;
+      }
+
+      index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int sibling = index;
+    int old_parent = nodes_[sibling].parent;
+    int new_parent = allocateNode();
+    nodes_[new_parent].parent = old_parent;
+    nodes_[new_parent].aabb = nodes_[sibling].aabb.GetMerged(leaf_aabb);
+    nodes_[new_parent].height = nodes_[sibling].height + 1;
+    nodes_[new_parent].child1 = sibling;
+    nodes_[new_parent].child2 = leaf;
+    nodes_[sibling].parent = new_parent;
+    nodes_[leaf].parent = new_parent;
+
+    if (old_parent != kNullNode) {
+      if (nodes_[old_parent].child1 == sibling) {
+        nodes_[old_parent].child1 = new_parent;
+      } else {
+        nodes_[old_parent].child2 = new_parent;
+      }
+    } else {
+      root_ = new_parent;
+    }
+
+    refitAncestors(new_parent);
+  }
+
+  void removeLeaf(int leaf) {
+    if (leaf == root_) {
+      root_ = kNullNode;
+      return;
+    }
+
+    int parent = nodes_[leaf].parent;
+    int grand_parent = nodes_[parent].parent;
+    int sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2
+                                                : nodes_[parent].child1;
+
+    if (grand_parent != kNullNode) {
+      if (nodes_[grand_parent].child1 == parent) {
+        nodes_[grand_parent].child1 = sibling;
+      } else {
+        nodes_[grand_parent].child2 = sibling;
+      }
+      nodes_[sibling].parent = grand_parent;
+      freeNode(parent);
+
+      refitAncestors(grand_parent);
+    } else {
+      root_ = sibling;
+      nodes_[sibling].parent = kNullNode;
+      freeNode(parent);
+    }
+
+    nodes_[leaf].parent = kNullNode;
+  }
+
+  void refitAncestors(int index) {
+    while (index != kNullNode) {
+      index = balance(index);
+
+      Node& node = nodes_[index];
+      const Node& child1 = nodes_[node.child1];
+      const Node& child2 = nodes_[node.child2];
+      node.height = 1 + std::max(child1.height, child2.height);
+      node.aabb = child1.aabb.GetMerged(child2.aabb);
+
+      index = node.parent;
+    }
+  }
+
+  void replaceChild(int parent, int old_child, int new_child) {
+    if (parent == kNullNode) {
+      root_ = new_child;
+    } else if (nodes_[parent].child1 == old_child) {
+      nodes_[parent].child1 = new_child;
+    } else {
+      nodes_[parent].child2 = new_child;
+    }
+  }
+
+  // Rotates the higher child of a up if subtrees heights differ by more than
+  // one. Returns index of the node that took a's place.
+  int balance(int a) {
+    Node& node_a = nodes_[a];
+    if (node_a.IsLeaf() || node_a.height < 2) {
+      return a;
+    }
+
+    int b = node_a.child1;
+    int c = node_a.child2;
+    Node& node_b = nodes_[b];
+    Node& node_c = nodes_[c];
+
+    int height_difference = node_c.height - node_b.height;
+
+    if (height_difference > 1) {
+      int f = node_c.child1;
+      int g = node_c.child2;
+      Node& node_f = nodes_[f];
+      Node& node_g = nodes_[g];
+
+      node_c.child1 = a;
+      node_c.parent = node_a.parent;
+      node_a.parent = c;
+      replaceChild(node_c.parent, a, c);
+
+      if (node_f.height > node_g.height) {
+        node_c.child2 = f;
+        node_a.child2 = g;
+        node_g.parent = a;
+        node_a.aabb = node_b.aabb.GetMerged(node_g.aabb);
+        node_c.aabb = node_a.aabb.GetMerged(node_f.aabb);
+        node_a.height = 1 + std::max(node_b.height, node_g.height);
+        node_c.height = 1 + std::max(node_a.height, node_f.height);
+      } else {
+        node_c.child2 = g;
+        node_a.child2 = f;
+        node_f.parent = a;
+        node_a.aabb = node_b.aabb.GetMerged(node_f.aabb);
+        node_c.aabb = node_a.aabb.GetMerged(node_g.aabb);
+        node_a.height = 1 + std::max(node_b.height, node_f.height);
+        node_c.height = 1 + std::max(node_a.height, node_g.height);
+      }
+
+      return c;
+    }
+
+    if (height_difference < -1) {
+      int d = node_b.child1;
+      int e = node_b.child2;
+      Node& node_d = nodes_[d];
+      Node& node_e = nodes_[e];
+
+      node_b.child1 = a;
+      node_b.parent = node_a.parent;
+      node_a.parent = b;
+      replaceChild(node_b.parent, a, b);
+
+      if (node_d.height > node_e.height) {
+        node_b.child2 = d;
+        node_a.child1 = e;
+        node_e.parent = a;
+        node_a.aabb = node_c.aabb.GetMerged(node_e.aabb);
+        node_b.aabb = node_a.aabb.GetMerged(node_d.aabb);
+        node_a.height = 1 + std::max(node_c.height, node_e.height);
+        node_b.height = 1 + std::max(node_a.height, node_d.height);
+      } else {
+        node_b.child2 = e;
+        node_a.child1 = d;
+        node_d.parent = a;
+        node_a.aabb = node_c.aabb.GetMerged(node_d.aabb);
+        node_b.aabb = node_a.aabb.GetMerged(node_e.aabb);
+        node_a.height = 1 + std::max(node_c.height, node_d.height);
+        node_b.height = 1 + std::max(node_a.height, node_e.height);
+      }
+
+      return b;
+    }
+
+    return a;
+  }
+
+  float fat_margin_{0.1f};
+  std::vector<Node> nodes_;
+  int root_{kNullNode};
+  int free_list_{kNullNode};
+};
+}  // namespace Collision
+}  // namespace Symphony
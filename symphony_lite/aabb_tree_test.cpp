@@ -0,0 +1,120 @@
+#include "aabb_tree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "random_generator.hpp"
+
+using namespace Symphony::Collision;
+using namespace Symphony::Math;
+using namespace Symphony::Random;
+
+namespace {
+std::vector<int> BruteForceQuery(const std::vector<AARect2d>& rects,
+                                 const AARect2d& query) {
+  std::vector<int> result;
+  for (int i = 0; i < (int)rects.size(); ++i) {
+    if (rects[i].IntersectRectangle(query).has_value()) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST(AABBTree2d, AddQueryRemove) {
+  AABBTree2d<int> tree(/* fat_margin= */ 0.0f);
+  int proxy1 = tree.Add(Point2d(0.0f, 0.0f), Vector2d(1.0f, 1.0f), 1);
+  int proxy2 = tree.Add(Point2d(10.0f, 0.0f), Vector2d(1.0f, 1.0f), 2);
+  tree.Add(Point2d(5.0f, 0.0f), Vector2d(10.0f, 1.0f), 3);
+
+  std::vector<int> result;
+  tree.Query(Point2d(0.0f, 0.0f), Vector2d(0.5f, 0.5f), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({1, 3}), result);
+
+  tree.Remove(proxy1);
+  tree.Query(Point2d(0.0f, 0.0f), Vector2d(0.5f, 0.5f), result);
+  ASSERT_EQ(std::vector<int>({3}), result);
+
+  ASSERT_TRUE(tree.Move(proxy2, Point2d(0.0f, 20.0f), Vector2d(1.0f, 1.0f)));
+  tree.Query(Point2d(0.0f, 20.0f), Vector2d(0.5f, 0.5f), result);
+  ASSERT_EQ(std::vector<int>({2}), result);
+  ASSERT_EQ(2, tree.GetObject(proxy2));
+}
+
+TEST(AABBTree2d, SmallMoveKeepsFatAABB) {
+  AABBTree2d<int> tree(/* fat_margin= */ 1.0f);
+  int proxy = tree.Add(Point2d(0.0f, 0.0f), Vector2d(1.0f, 1.0f), 1);
+  ASSERT_FALSE(tree.Move(proxy, Point2d(0.5f, 0.5f), Vector2d(1.0f, 1.0f)));
+  ASSERT_TRUE(tree.Move(proxy, Point2d(1.5f, 0.0f), Vector2d(1.0f, 1.0f)));
+}
+
+TEST(AABBTree2d, MatchesBruteForceAndStaysBalanced) {
+  RandomGenerator random;
+  random.SetSeed(42);
+
+  AABBTree2d<int> tree(/* fat_margin= */ 0.0f);
+  std::vector<AARect2d> rects;
+  std::vector<int> proxies;
+  for (int i = 0; i < 1000; ++i) {
+    AARect2d rect(
+        Point2d(random.NextFloat(-500.0f, 500.0f),
+                random.NextFloat(-500.0f, 500.0f)),
+        Vector2d(random.NextFloat(0.5f, 50.0f),
+                 random.NextFloat(0.5f, 5.0f)));
+    rects.push_back(rect);
+    proxies.push_back(tree.Add(rect.center, rect.half_size, i));
+  }
+  ASSERT_LE(tree.GetHeight(), 2 * (int)std::ceil(std::log2(1000.0f)));
+
+  for (int i = 0; i < 1000; i += 3) {
+    rects[i].center = rects[i].center + Vector2d(30.0f, -20.0f);
+    tree.Move(proxies[i], rects[i].center, rects[i].half_size);
+  }
+
+  std::vector<int> result;
+  for (int i = 0; i < 100; ++i) {
+    AARect2d query(Point2d(random.NextFloat(-500.0f, 500.0f),
+                           random.NextFloat(-500.0f, 500.0f)),
+                   Vector2d(20.0f, 20.0f));
+    tree.Query(query.center, query.half_size, result);
+    std::sort(result.begin(), result.end());
+    ASSERT_EQ(BruteForceQuery(rects, query), result);
+  }
+}
+
+TEST(AABBTree2d, RayCastReportsClosest) {
+  AABBTree2d<int> tree(/* fat_margin= */ 0.0f);
+  std::vector<AARect2d> rects = {
+      AARect2d(Point2d(10.0f, 0.0f), Vector2d(1.0f, 1.0f)),
+      AARect2d(Point2d(5.0f, 0.0f), Vector2d(1.0f, 1.0f)),
+      AARect2d(Point2d(5.0f, 10.0f), Vector2d(1.0f, 1.0f)),
+  };
+  for (int i = 0; i < (int)rects.size(); ++i) {
+    tree.Add(rects[i].center, rects[i].half_size, i);
+  }
+
+  Point2d ray_start(0.0f, 0.0f);
+  Vector2d ray_dir(1.0f, 0.0f);
+  int closest = -1;
+  auto distance = tree.RayCast(
+      ray_start, ray_dir, /* max_distance= */ 100.0f,
+      [&](int object) -> std::optional<float> {
+        float d = 0.0f;
+        if (!rects[object].IntersectRay(ray_start, ray_dir, 100.0f, d)) {
+          return std::nullopt;
+        }
+        closest = object;
+        return d;
+      });
+  ASSERT_TRUE(distance.has_value());
+  ASSERT_NEAR(4.0f, distance.value(), eps);
+  ASSERT_EQ(1, closest);
+
+  distance = tree.RayCast(ray_start, ray_dir, /* max_distance= */ 3.0f,
+                          [&](int) -> std::optional<float> { return 0.0f; });
+  ASSERT_FALSE(distance.has_value());
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <new>
+#include <vector>
+
+namespace Symphony {
+namespace Memory {
+// Lets std::vector hand out storage suitable for aligned SIMD loads.
+template <typename T, size_t kAlignment>
+class AlignedAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, kAlignment>;
+  };
+
+  AlignedAllocator() = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, kAlignment>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t(kAlignment)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    (void)n;
+    ::operator delete(p, std::align_val_t(kAlignment));
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, kAlignment>&) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, kAlignment>&) const {
+    return false;
+  }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T, 32>>;
+}  // namespace Memory
+}  // namespace Symphony
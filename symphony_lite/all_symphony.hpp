@@ -1,25 +1,42 @@
 #pragma once
 
 #include "aa_rect2d.hpp"
+#include "aabb_tree.hpp"
+#include "aligned_allocator.hpp"
 #include "angle.hpp"
 #include "animated_sprite.hpp"
 #include "audio.hpp"
+#include "batch_intersection.hpp"
+#include "billboard_renderer.hpp"
 #include "bm_font_loader.hpp"
 #include "circle.hpp"
+#include "constexpr_math.hpp"
+#include "contact_manifold.hpp"
+#include "continuous_collision.hpp"
+#include "distance_shading.hpp"
+#include "fast_math.hpp"
+#include "fixed_point.hpp"
 #include "font.hpp"
 #include "formatted_text.hpp"
 #include "hash.hpp"
+#include "hierarchical_spatial_bins.hpp"
 #include "log.hpp"
 #include "measured_text.hpp"
 #include "point2d.hpp"
 #include "point3d.hpp"
+#include "portal_visibility.hpp"
+#include "quaternion.hpp"
 #include "random_generator.hpp"
 #include "ray_casting_projection.hpp"
+#include "ray_casting_renderer.hpp"
 #include "segment2d.hpp"
+#include "simd.hpp"
 #include "spatial_bins.hpp"
 #include "sprite_sheet.hpp"
 #include "text.hpp"
+#include "thread_pool.hpp"
 #include "transformation_matrix3d.hpp"
+#include "vec2_array.hpp"
 #include "vector2d.hpp"
 #include "vector3d.hpp"
 #include "wave_loader.hpp"
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "aa_rect2d.hpp"
+#include "circle.hpp"
+#include "segment2d.hpp"
+
+namespace Symphony {
+namespace Collision {
+// Structure of arrays storage for the narrow phase, fill it with what the
+// broad phase returned and test one shape against all of them at once.
+struct AARect2dBatch {
+  void Clear() {
+    center_x.clear();
+    center_y.clear();
+    half_width.clear();
+    half_height.clear();
+  }
+
+  void Add(const Math::AARect2d& rect) {
+    center_x.push_back(rect.center.x);
+    center_y.push_back(rect.center.y);
+    half_width.push_back(rect.half_size.x);
+    half_height.push_back(rect.half_size.y);
+  }
+
+  int Size() const { return (int)center_x.size(); }
+
+  std::vector<float> center_x;
+  std::vector<float> center_y;
+  std::vector<float> half_width;
+  std::vector<float> half_height;
+};
+
+struct CircleBatch {
+  void Clear() {
+    center_x.clear();
+    center_y.clear();
+    radius.clear();
+  }
+
+  void Add(const Math::Circle& circle) {
+    center_x.push_back(circle.center.x);
+    center_y.push_back(circle.center.y);
+    radius.push_back(circle.radius);
+  }
+
+  int Size() const { return (int)center_x.size(); }
+
+  std::vector<float> center_x;
+  std::vector<float> center_y;
+  std::vector<float> radius;
+};
+
+struct Segment2dBatch {
+  void Clear() {
+    p0_x.clear();
+    p0_y.clear();
+    p1_x.clear();
+    p1_y.clear();
+  }
+
+  void Add(const Math::Segment2d& segment) {
+    p0_x.push_back(segment.p0.x);
+    p0_y.push_back(segment.p0.y);
+    p1_x.push_back(segment.p1.x);
+    p1_y.push_back(segment.p1.y);
+  }
+
+  int Size() const { return (int)p0_x.size(); }
+
+  std::vector<float> p0_x;
+  std::vector<float> p0_y;
+  std::vector<float> p1_x;
+  std::vector<float> p1_y;
+};
+
+// Bit i of the mask is set when the shape hits element i of the batch.
+inline bool IsHit(const std::vector<uint32_t>& hit_mask, int index) {
+  return (hit_mask[index >> 5] >> (index & 31)) & 1;
+}
+
+namespace {
+inline void resetHitMask(int size, std::vector<uint32_t>& hit_mask_out) {
+  hit_mask_out.assign((size + 31) / 32, 0);
+}
+
+inline void setHit(int index, std::vector<uint32_t>& hit_mask_out) {
+  hit_mask_out[index >> 5] |= 1u << (index & 31);
+}
+
+// Lanes are processed in groups that never straddle a mask word.
+#if defined(__AVX__)
+const int kBatchLanes = 8;
+#elif defined(__SSE2__)
+const int kBatchLanes = 4;
+#else
+const int kBatchLanes = 1;
+#endif
+}  // namespace
+
+/// Same result as rect.Intersect(batch[i]) for every i.
+inline void IntersectBatch(const Math::AARect2d& rect,
+                           const AARect2dBatch& batch,
+                           std::vector<uint32_t>& hit_mask_out) {
+  int size = batch.Size();
+  resetHitMask(size, hit_mask_out);
+
+  float left = rect.center.x - rect.half_size.x;
+  float right = rect.center.x + rect.half_size.x;
+  float bottom = rect.center.y - rect.half_size.y;
+  float top = rect.center.y + rect.half_size.y;
+
+  const float* center_x = batch.center_x.data();
+  const float* center_y = batch.center_y.data();
+  const float* half_width = batch.half_width.data();
+  const float* half_height = batch.half_height.data();
+
+  int i = 0;
+#if defined(__AVX__)
+  __m256 left_v = _mm256_set1_ps(left);
+  __m256 right_v = _mm256_set1_ps(right);
+  __m256 bottom_v = _mm256_set1_ps(bottom);
+  __m256 top_v = _mm256_set1_ps(top);
+  __m256 eps_v = _mm256_set1_ps(Math::eps);
+  for (; i + kBatchLanes <= size; i += kBatchLanes) {
+    __m256 cx = _mm256_loadu_ps(center_x + i);
+    __m256 cy = _mm256_loadu_ps(center_y + i);
+    __m256 hw = _mm256_loadu_ps(half_width + i);
+    __m256 hh = _mm256_loadu_ps(half_height + i);
+    __m256 overlap_x =
+        _mm256_sub_ps(_mm256_min_ps(right_v, _mm256_add_ps(cx, hw)),
+                      _mm256_max_ps(left_v, _mm256_sub_ps(cx, hw)));
+    __m256 overlap_y =
+        _mm256_sub_ps(_mm256_min_ps(top_v, _mm256_add_ps(cy, hh)),
+                      _mm256_max_ps(bottom_v, _mm256_sub_ps(cy, hh)));
+    __m256 hit = _mm256_and_ps(_mm256_cmp_ps(overlap_x, eps_v, _CMP_GE_OQ),
+                               _mm256_cmp_ps(overlap_y, eps_v, _CMP_GE_OQ));
+    hit_mask_out[i >> 5] |= (uint32_t)_mm256_movemask_ps(hit) << (i & 31);
+  }
+#elif defined(__SSE2__)
+  __m128 left_v = _mm_set1_ps(left);
+  __m128 right_v = _mm_set1_ps(right);
+  __m128 bottom_v = _mm_set1_ps(bottom);
+  __m128 top_v = _mm_set1_ps(top);
+  __m128 eps_v = _mm_set1_ps(Math::eps);
+  for (; i + kBatchLanes <= size; i += kBatchLanes) {
+    __m128 cx = _mm_loadu_ps(center_x + i);
+    __m128 cy = _mm_loadu_ps(center_y + i);
+    __m128 hw = _mm_loadu_ps(half_width + i);
+    __m128 hh = _mm_loadu_ps(half_height + i);
+    __m128 overlap_x = _mm_sub_ps(_mm_min_ps(right_v, _mm_add_ps(cx, hw)),
+                                  _mm_max_ps(left_v, _mm_sub_ps(cx, hw)));
+    __m128 overlap_y = _mm_sub_ps(_mm_min_ps(top_v, _mm_add_ps(cy, hh)),
+                                  _mm_max_ps(bottom_v, _mm_sub_ps(cy, hh)));
+    __m128 hit = _mm_and_ps(_mm_cmpge_ps(overlap_x, eps_v),
+                            _mm_cmpge_ps(overlap_y, eps_v));
+    hit_mask_out[i >> 5] |= (uint32_t)_mm_movemask_ps(hit) << (i & 31);
+  }
+#endif
+  for (; i < size; ++i) {
+    float overlap_x = std::min(right, center_x[i] + half_width[i]) -
+                      std::max(left, center_x[i] - half_width[i]);
+    float overlap_y = std::min(top, center_y[i] + half_height[i]) -
+                      std::max(bottom, center_y[i] - half_height[i]);
+    if (overlap_x >= Math::eps && overlap_y >= Math::eps) {
+      setHit(i, hit_mask_out);
+    }
+  }
+}
+
+/// Same result as circle.Intersect(batch[i]) for every i.
+inline void IntersectBatch(const Math::Circle& circle, const CircleBatch& batch,
+                           std::vector<uint32_t>& hit_mask_out) {
+  int size = batch.Size();
+  resetHitMask(size, hit_mask_out);
+
+  const float* center_x = batch.center_x.data();
+  const float* center_y = batch.center_y.data();
+  const float* radius = batch.radius.data();
+
+  int i = 0;
+#if defined(__AVX__)
+  __m256 x_v = _mm256_set1_ps(circle.center.x);
+  __m256 y_v = _mm256_set1_ps(circle.center.y);
+  __m256 r_v = _mm256_set1_ps(circle.radius);
+  for (; i + kBatchLanes <= size; i += kBatchLanes) {
+    __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(center_x + i), x_v);
+    __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(center_y + i), y_v);
+    __m256 r = _mm256_add_ps(_mm256_loadu_ps(radius + i), r_v);
+    __m256 d_sq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    __m256 hit = _mm256_cmp_ps(d_sq, _mm256_mul_ps(r, r), _CMP_LE_OQ);
+    hit_mask_out[i >> 5] |= (uint32_t)_mm256_movemask_ps(hit) << (i & 31);
+  }
+#elif defined(__SSE2__)
+  __m128 x_v = _mm_set1_ps(circle.center.x);
+  __m128 y_v = _mm_set1_ps(circle.center.y);
+  __m128 r_v = _mm_set1_ps(circle.radius);
+  for (; i + kBatchLanes <= size; i += kBatchLanes) {
+    __m128 dx = _mm_sub_ps(_mm_loadu_ps(center_x + i), x_v);
+    __m128 dy = _mm_sub_ps(_mm_loadu_ps(center_y + i), y_v);
+    __m128 r = _mm_add_ps(_mm_loadu_ps(radius + i), r_v);
+    __m128 d_sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    __m128 hit = _mm_cmple_ps(d_sq, _mm_mul_ps(r, r));
+    hit_mask_out[i >> 5] |= (uint32_t)_mm_movemask_ps(hit) << (i & 31);
+  }
+#endif
+  for (; i < size; ++i) {
+    float dx = center_x[i] - circle.center.x;
+    float dy = center_y[i] - circle.center.y;
+    float r = radius[i] + circle.radius;
+    if (dx * dx + dy * dy <= r * r) {
+      setHit(i, hit_mask_out);
+    }
+  }
+}
+
+/// Same result as segment.Intersect(batch[i], eps, ...) for every i. The
+/// fraction tests are done without division: t = t_num / D is in [0, 1]
+/// when t_num * sign(D) is in [0, |D|].
+inline void IntersectBatch(const Math::Segment2d& segment,
+                           const Segment2dBatch& batch, float eps,
+                           std::vector<uint32_t>& hit_mask_out) {
+  int size = batch.Size();
+  resetHitMask(size, hit_mask_out);
+
+  float v1_x = segment.p1.x - segment.p0.x;
+  float v1_y = segment.p1.y - segment.p0.y;
+
+  const float* p0_x = batch.p0_x.data();
+  const float* p0_y = batch.p0_y.data();
+  const float* p1_x = batch.p1_x.data();
+  const float* p1_y = batch.p1_y.data();
+
+  int i = 0;
+#if defined(__AVX__)
+  __m256 sp0_x = _mm256_set1_ps(segment.p0.x);
+  __m256 sp0_y = _mm256_set1_ps(segment.p0.y);
+  __m256 v1_x_v = _mm256_set1_ps(v1_x);
+  __m256 v1_y_v = _mm256_set1_ps(v1_y);
+  __m256 eps_v = _mm256_set1_ps(eps);
+  __m256 zero = _mm256_setzero_ps();
+  __m256 sign_bit = _mm256_set1_ps(-0.0f);
+  for (; i + kBatchLanes <= size; i += kBatchLanes) {
+    __m256 q0_x = _mm256_loadu_ps(p0_x + i);
+    __m256 q0_y = _mm256_loadu_ps(p0_y + i);
+    __m256 v2_x = _mm256_sub_ps(_mm256_loadu_ps(p1_x + i), q0_x);
+    __m256 v2_y = _mm256_sub_ps(_mm256_loadu_ps(p1_y + i), q0_y);
+    __m256 a_x = _mm256_sub_ps(q0_x, sp0_x);
+    __m256 a_y = _mm256_sub_ps(q0_y, sp0_y);
+
+    __m256 d = _mm256_sub_ps(_mm256_mul_ps(v1_x_v, v2_y),
+                             _mm256_mul_ps(v1_y_v, v2_x));
+    __m256 t_num =
+        _mm256_sub_ps(_mm256_mul_ps(a_x, v2_y), _mm256_mul_ps(a_y, v2_x));
+    __m256 u_num =
+        _mm256_sub_ps(_mm256_mul_ps(a_x, v1_y_v), _mm256_mul_ps(a_y, v1_x_v));
+
+    __m256 d_sign = _mm256_and_ps(d, sign_bit);
+    __m256 d_abs = _mm256_andnot_ps(sign_bit, d);
+    t_num = _mm256_xor_ps(t_num, d_sign);
+    u_num = _mm256_xor_ps(u_num, d_sign);
+
+    __m256 hit = _mm256_cmp_ps(d_abs, eps_v, _CMP_GE_OQ);
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(t_num, zero, _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(t_num, d_abs, _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(u_num, zero, _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(u_num, d_abs, _CMP_LE_OQ));
+    hit_mask_out[i >> 5] |= (uint32_t)_mm256_movemask_ps(hit) << (i & 31);
+  }
+#elif defined(__SSE2__)
+  __m128 sp0_x = _mm_set1_ps(segment.p0.x);
+  __m128 sp0_y = _mm_set1_ps(segment.p0.y);
+  __m128 v1_x_v = _mm_set1_ps(v1_x);
+  __m128 v1_y_v = _mm_set1_ps(v1_y);
+  __m128 eps_v = _mm_set1_ps(eps);
+  __m128 zero = _mm_setzero_ps();
+  __m128 sign_bit = _mm_set1_ps(-0.0f);
+  for (; i + kBatchLanes <= size; i += kBatchLanes) {
+    __m128 q0_x = _mm_loadu_ps(p0_x + i);
+    __m128 q0_y = _mm_loadu_ps(p0_y + i);
+    __m128 v2_x = _mm_sub_ps(_mm_loadu_ps(p1_x + i), q0_x);
+    __m128 v2_y = _mm_sub_ps(_mm_loadu_ps(p1_y + i), q0_y);
+    __m128 a_x = _mm_sub_ps(q0_x, sp0_x);
+    __m128 a_y = _mm_sub_ps(q0_y, sp0_y);
+
+    __m128 d = _mm_sub_ps(_mm_mul_ps(v1_x_v, v2_y), _mm_mul_ps(v1_y_v, v2_x));
+    __m128 t_num = _mm_sub_ps(_mm_mul_ps(a_x, v2_y), _mm_mul_ps(a_y, v2_x));
+    __m128 u_num =
+        _mm_sub_ps(_mm_mul_ps(a_x, v1_y_v), _mm_mul_ps(a_y, v1_x_v));
+
+    __m128 d_sign = _mm_and_ps(d, sign_bit);
+    __m128 d_abs = _mm_andnot_ps(sign_bit, d);
+    t_num = _mm_xor_ps(t_num, d_sign);
+    u_num = _mm_xor_ps(u_num, d_sign);
+
+    __m128 hit = _mm_cmpge_ps(d_abs, eps_v);
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(t_num, zero));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(t_num, d_abs));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(u_num, zero));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(u_num, d_abs));
+    hit_mask_out[i >> 5] |= (uint32_t)_mm_movemask_ps(hit) << (i & 31);
+  }
+#endif
+  for (; i < size; ++i) {
+    float v2_x = p1_x[i] - p0_x[i];
+    float v2_y = p1_y[i] - p0_y[i];
+    float a_x = p0_x[i] - segment.p0.x;
+    float a_y = p0_y[i] - segment.p0.y;
+
+    float d = v1_x * v2_y - v1_y * v2_x;
+    float t_num = a_x * v2_y - a_y * v2_x;
+    float u_num = a_x * v1_y - a_y * v1_x;
+    if (d < 0.0f) {
+      d = -d;
+      t_num = -t_num;
+      u_num = -u_num;
+    }
+
+    if (d >= eps && t_num >= 0.0f && t_num <= d && u_num >= 0.0f &&
+        u_num <= d) {
+      setHit(i, hit_mask_out);
+    }
+  }
+}
+}  // namespace Collision
+}  // namespace Symphony
@@ -0,0 +1,94 @@
+#include "batch_intersection.hpp"
+
+#include <gtest/gtest.h>
+
+#include "random_generator.hpp"
+
+using namespace Symphony::Collision;
+using namespace Symphony::Math;
+using namespace Symphony::Random;
+
+namespace {
+Point2d RandomPoint(RandomGenerator& random) {
+  return Point2d(random.NextFloat(-50.0f, 50.0f),
+                 random.NextFloat(-50.0f, 50.0f));
+}
+
+// Not a multiple of any SIMD width to cover the scalar tail.
+const int kBatchSize = 1003;
+}  // namespace
+
+TEST(BatchIntersection, AARect2d) {
+  RandomGenerator random;
+  random.SetSeed(1);
+
+  AARect2d rect(Point2d(0.0f, 0.0f), Vector2d(10.0f, 5.0f));
+  std::vector<AARect2d> rects;
+  AARect2dBatch batch;
+  for (int i = 0; i < kBatchSize; ++i) {
+    rects.push_back(AARect2d(RandomPoint(random),
+                             Vector2d(random.NextFloat(0.0f, 10.0f),
+                                      random.NextFloat(0.0f, 10.0f))));
+    batch.Add(rects.back());
+  }
+
+  std::vector<uint32_t> hit_mask;
+  IntersectBatch(rect, batch, hit_mask);
+
+  int num_hits = 0;
+  for (int i = 0; i < kBatchSize; ++i) {
+    ASSERT_EQ(rect.Intersect(rects[i]), IsHit(hit_mask, i)) << i;
+    num_hits += IsHit(hit_mask, i) ? 1 : 0;
+  }
+  ASSERT_GT(num_hits, 0);
+}
+
+TEST(BatchIntersection, Circle) {
+  RandomGenerator random;
+  random.SetSeed(2);
+
+  Circle circle(Point2d(5.0f, -5.0f), 12.0f);
+  std::vector<Circle> circles;
+  CircleBatch batch;
+  for (int i = 0; i < kBatchSize; ++i) {
+    circles.push_back(Circle(RandomPoint(random), random.NextFloat(0, 8)));
+    batch.Add(circles.back());
+  }
+
+  std::vector<uint32_t> hit_mask;
+  IntersectBatch(circle, batch, hit_mask);
+
+  int num_hits = 0;
+  for (int i = 0; i < kBatchSize; ++i) {
+    ASSERT_EQ(circle.Intersect(circles[i]), IsHit(hit_mask, i)) << i;
+    num_hits += IsHit(hit_mask, i) ? 1 : 0;
+  }
+  ASSERT_GT(num_hits, 0);
+}
+
+TEST(BatchIntersection, Segment2d) {
+  RandomGenerator random;
+  random.SetSeed(3);
+
+  Segment2d segment(Point2d(-40.0f, -30.0f), Point2d(35.0f, 45.0f));
+  std::vector<Segment2d> segments;
+  Segment2dBatch batch;
+  for (int i = 0; i < kBatchSize; ++i) {
+    segments.push_back(Segment2d(RandomPoint(random), RandomPoint(random)));
+    batch.Add(segments.back());
+  }
+  segments.push_back(Segment2d(Point2d(-40.0f, -30.0f), Point2d(35.0f, 45.0f)));
+  batch.Add(segments.back());
+
+  std::vector<uint32_t> hit_mask;
+  IntersectBatch(segment, batch, /* eps= */ 0.00001f, hit_mask);
+
+  int num_hits = 0;
+  for (int i = 0; i < (int)segments.size(); ++i) {
+    Point2d p;
+    ASSERT_EQ(segment.Intersect(segments[i], 0.00001f, p), IsHit(hit_mask, i))
+        << i;
+    num_hits += IsHit(hit_mask, i) ? 1 : 0;
+  }
+  ASSERT_GT(num_hits, 0);
+}
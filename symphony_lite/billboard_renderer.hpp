@@ -0,0 +1,201 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "point2d.hpp"
+#include "ray_casting_projection.hpp"
+#include "ray_casting_renderer.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Visibility {
+// Camera facing sprite standing in the world of a ray casting renderer.
+struct Billboard {
+  Math::Point2d position;
+  /// Height of the bottom edge.
+  float z{0.0f};
+  float width{1.0f};
+  float height{1.0f};
+  int texture{0};
+};
+
+// Draws billboards over a frame rendered by RayCastingRenderer: projects all
+// of them in one pass, drops the ones outside of the view, sorts the rest
+// back to front with a radix sort and draws each column only where it is
+// closer than the wall.
+class BillboardRenderer {
+ public:
+  /// Sprites closer than this to the camera plane are dropped.
+  static constexpr float kNearDistance = 0.05f;
+
+  /// \arg textures Pixels with zero alpha (the high byte) are transparent.
+  /// \arg depth_buffer Wall depth per column, see
+  /// RayCastingRenderer::GetDepthBuffer.
+  void Render(const RayCastingProjection& projection,
+              const std::vector<Billboard>& billboards,
+              const std::vector<Image>& textures,
+              const std::vector<float>& depth_buffer, Image& frame_buffer) {
+    projectAll(projection, billboards);
+    cull(projection, billboards, frame_buffer.width, frame_buffer.height);
+    sortBackToFront();
+    for (const Visible& visible : visible_) {
+      draw(visible, textures[billboards[visible.index].texture], depth_buffer,
+           frame_buffer);
+    }
+  }
+
+  /// Billboards drawn by the last Render.
+  int GetNumVisible() const { return (int)visible_.size(); }
+
+ private:
+  struct Visible {
+    /// Sort key, larger is closer.
+    uint32_t key;
+    int index;
+    float depth;
+    // Screen rect in pixels.
+    float left;
+    float right;
+    float top;
+    float bottom;
+  };
+
+  // Camera space coordinates of every billboard, a tight loop over
+  // positions the compiler can vectorize.
+  void projectAll(const RayCastingProjection& projection,
+                  const std::vector<Billboard>& billboards) {
+    const Math::Point2d& origin = projection.GetCameraOrigin();
+    const Math::Vector2d& forward = projection.GetCameraDirection();
+    const Math::Vector2d& right = projection.GetCameraRight();
+
+    int size = (int)billboards.size();
+    depths_.resize(size);
+    sides_.resize(size);
+    for (int i = 0; i < size; ++i) {
+      Math::Vector2d to_billboard = billboards[i].position - origin;
+      depths_[i] = to_billboard * forward;
+      sides_[i] = to_billboard * right;
+    }
+  }
+
+  void cull(const RayCastingProjection& projection,
+            const std::vector<Billboard>& billboards, int screen_width,
+            int screen_height) {
+    // Same mapping as RayCastingProjection::Project, factored so one
+    // division per billboard is left: screen offsets of a point one unit
+    // ahead, one unit up and one unit right.
+    float camera_z = projection.GetCameraZ();
+    Math::Point2d ahead = projection.GetCameraOrigin() +
+                          projection.GetCameraDirection();
+    float vertical_scale = projection.Project(ahead, camera_z + 1.0f).y;
+    float horizontal_scale =
+        projection.Project(ahead + projection.GetCameraRight(), camera_z).x;
+    float half_width = (float)(screen_width / 2);
+    float half_height = (float)screen_height * 0.5f;
+
+    visible_.clear();
+    for (int i = 0; i < (int)billboards.size(); ++i) {
+      float depth = depths_[i];
+      if (depth < kNearDistance) {
+        continue;
+      }
+
+      const Billboard& billboard = billboards[i];
+      float depth_inv = 1.0f / depth;
+      float center_x =
+          half_width + sides_[i] * horizontal_scale * depth_inv * half_width;
+      float size_x =
+          billboard.width * 0.5f * horizontal_scale * depth_inv * half_width;
+
+      Visible visible;
+      visible.left = center_x - size_x;
+      visible.right = center_x + size_x;
+      visible.top =
+          (1.0f - (billboard.z + billboard.height - camera_z) *
+                      vertical_scale * depth_inv) *
+          half_height;
+      visible.bottom =
+          (1.0f - (billboard.z - camera_z) * vertical_scale * depth_inv) *
+          half_height;
+      if (visible.right <= 0.0f || visible.left >= (float)screen_width ||
+          visible.bottom <= 0.0f || visible.top >= (float)screen_height) {
+        continue;
+      }
+
+      // Bits of a positive float sort like the float. Inverted, so the
+      // farthest billboard gets the smallest key.
+      uint32_t depth_bits = 0;
+      memcpy(&depth_bits, &depth, sizeof(depth_bits));
+      visible.key = ~depth_bits;
+      visible.index = i;
+      visible.depth = depth;
+      visible_.push_back(visible);
+    }
+  }
+
+  // LSD radix sort on 8 bit digits, stable and linear in the number of
+  // billboards.
+  void sortBackToFront() {
+    sort_buffer_.resize(visible_.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+      int offsets[257] = {};
+      for (const Visible& visible : visible_) {
+        ++offsets[((visible.key >> shift) & 0xff) + 1];
+      }
+      for (int i = 1; i < 257; ++i) {
+        offsets[i] += offsets[i - 1];
+      }
+      for (const Visible& visible : visible_) {
+        sort_buffer_[offsets[(visible.key >> shift) & 0xff]++] = visible;
+      }
+      visible_.swap(sort_buffer_);
+    }
+  }
+
+  static void draw(const Visible& visible, const Image& texture,
+                   const std::vector<float>& depth_buffer,
+                   Image& frame_buffer) {
+    int x_begin = std::max((int)ceilf(visible.left - 0.5f), 0);
+    int x_end = std::min((int)ceilf(visible.right - 0.5f), frame_buffer.width);
+    int y_begin = std::max((int)ceilf(visible.top - 0.5f), 0);
+    int y_end =
+        std::min((int)ceilf(visible.bottom - 0.5f), frame_buffer.height);
+
+    float u_step = (float)texture.width / (visible.right - visible.left);
+    float v_step = (float)texture.height / (visible.bottom - visible.top);
+    float v_begin = ((float)y_begin + 0.5f - visible.top) * v_step;
+    int max_u = texture.width - 1;
+    int max_v = texture.height - 1;
+
+    for (int x = x_begin; x < x_end; ++x) {
+      if (visible.depth >= depth_buffer[x]) {
+        continue;
+      }
+
+      int u = std::min(
+          (int)(((float)x + 0.5f - visible.left) * u_step), max_u);
+      const uint32_t* texture_column = texture.GetColumn(u);
+      uint32_t* column = frame_buffer.GetColumn(x);
+      float v = v_begin;
+      for (int y = y_begin; y < y_end; ++y) {
+        uint32_t color = texture_column[std::min((int)v, max_v)];
+        if ((color >> 24) != 0) {
+          column[y] = color;
+        }
+        v += v_step;
+      }
+    }
+  }
+
+  std::vector<float> depths_;
+  std::vector<float> sides_;
+  std::vector<Visible> visible_;
+  std::vector<Visible> sort_buffer_;
+};
+}  // namespace Visibility
+}  // namespace Symphony
@@ -0,0 +1,164 @@
+#include "billboard_renderer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "random_generator.hpp"
+
+using namespace Symphony::Math;
+using namespace Symphony::Visibility;
+
+namespace {
+const uint32_t kWallColor = 0xffff0000;
+
+// Room with walls on the border.
+TileMap MakeRoom(int size) {
+  TileMap map(size, size);
+  for (int i = 0; i < size; ++i) {
+    map.Set(i, 0, 1);
+    map.Set(i, size - 1, 1);
+    map.Set(0, i, 1);
+    map.Set(size - 1, i, 1);
+  }
+  return map;
+}
+
+Image MakeSolidTexture(uint32_t color) {
+  Image texture(4, 4);
+  std::fill(texture.pixels.begin(), texture.pixels.end(), color);
+  return texture;
+}
+
+class BillboardRendererTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    projection_.SetCamera(Point2d(4.5f, 1.5f), 0.5f, Vector2d(0.0f, 1.0f));
+    frame_buffer_.Resize(64, 48);
+    RayCastingParameters parameters;
+    std::vector<Image> wall_textures = {MakeSolidTexture(kWallColor)};
+    walls_.Render(projection_, map_, wall_textures, parameters,
+                  frame_buffer_);
+  }
+
+  void render(const std::vector<Billboard>& billboards,
+              const std::vector<Image>& textures) {
+    billboards_.Render(projection_, billboards, textures,
+                       walls_.GetDepthBuffer(), frame_buffer_);
+  }
+
+  TileMap map_ = MakeRoom(8);
+  RayCastingProjection projection_{64, 48, 90.0f};
+  RayCastingRenderer walls_;
+  BillboardRenderer billboards_;
+  Image frame_buffer_;
+};
+}  // namespace
+
+TEST_F(BillboardRendererTest, Cull) {
+  std::vector<Image> textures = {MakeSolidTexture(0xff0000ff)};
+  Billboard in_view;
+  in_view.position = Point2d(4.5f, 4.5f);
+  Billboard behind_camera;
+  behind_camera.position = Point2d(4.5f, 0.5f);
+  Billboard left_of_view;
+  left_of_view.position = Point2d(-10.0f, 3.5f);
+  Billboard at_camera;
+  at_camera.position = Point2d(4.5f, 1.5f);
+  render({in_view, behind_camera, left_of_view, at_camera}, textures);
+
+  EXPECT_EQ(1, billboards_.GetNumVisible());
+}
+
+TEST_F(BillboardRendererTest, SizeAndPosition) {
+  const uint32_t kColor = 0xff0000ff;
+  std::vector<Image> textures = {MakeSolidTexture(kColor)};
+  // 3 units ahead, 90 degree fov: the screen is 6 units wide there.
+  Billboard billboard;
+  billboard.position = Point2d(4.5f, 4.5f);
+  billboard.width = 1.5f;
+  billboard.height = 1.0f;
+  render({billboard}, textures);
+
+  // 1.5 / 6 of 64 columns around the center.
+  int row = 24;
+  EXPECT_NE(kColor, frame_buffer_.Get(23, row));
+  for (int x = 24; x < 40; ++x) {
+    EXPECT_EQ(kColor, frame_buffer_.Get(x, row)) << x;
+  }
+  EXPECT_NE(kColor, frame_buffer_.Get(40, row));
+
+  // Camera is at half the billboard height, so it is centered vertically.
+  int column = 32;
+  int top = 0;
+  while (frame_buffer_.Get(column, top) != kColor) {
+    ++top;
+  }
+  int bottom = 47;
+  while (frame_buffer_.Get(column, bottom) != kColor) {
+    --bottom;
+  }
+  EXPECT_EQ(47 - bottom, top);
+}
+
+TEST_F(BillboardRendererTest, OccludedByWalls) {
+  const uint32_t kColor = 0xff0000ff;
+  std::vector<Image> textures = {MakeSolidTexture(kColor)};
+  // Wider than the screen, behind the wall in the middle of the view.
+  Billboard billboard;
+  billboard.position = Point2d(4.5f, 9.0f);
+  billboard.width = 40.0f;
+  render({billboard}, textures);
+
+  EXPECT_EQ(1, billboards_.GetNumVisible());
+  for (uint32_t color : frame_buffer_.pixels) {
+    ASSERT_NE(kColor, color);
+  }
+}
+
+TEST_F(BillboardRendererTest, Transparency) {
+  Image texture = MakeSolidTexture(0xff0000ff);
+  for (int y = 0; y < 4; ++y) {
+    texture.Set(0, y, 0x00ffffff);
+  }
+  Billboard billboard;
+  billboard.position = Point2d(4.5f, 4.5f);
+  billboard.width = 1.5f;
+  render({billboard}, {texture});
+
+  // Left quarter of the billboard shows the wall behind.
+  EXPECT_EQ(kWallColor, frame_buffer_.Get(25, 24));
+  EXPECT_EQ(0xff0000ffu, frame_buffer_.Get(29, 24));
+}
+
+TEST_F(BillboardRendererTest, NearestDrawnLast) {
+  const int kNumBillboards = 1000;
+  // Distinct depths in shuffled order.
+  std::vector<int> order(kNumBillboards);
+  for (int i = 0; i < kNumBillboards; ++i) {
+    order[i] = i;
+  }
+  Symphony::Random::RandomGenerator random;
+  for (int i = kNumBillboards - 1; i > 0; --i) {
+    std::swap(order[i], order[random.NextValue() % (i + 1)]);
+  }
+
+  std::vector<Image> textures;
+  std::vector<Billboard> billboards;
+  int nearest = 0;
+  for (int i = 0; i < kNumBillboards; ++i) {
+    textures.push_back(MakeSolidTexture(0xff000000 | (uint32_t)i));
+    Billboard billboard;
+    billboard.position = Point2d(4.5f, 2.0f + (float)order[i] * 0.004f);
+    billboard.texture = i;
+    billboards.push_back(billboard);
+    if (order[i] == 0) {
+      nearest = i;
+    }
+  }
+  render(billboards, textures);
+
+  EXPECT_EQ(kNumBillboards, billboards_.GetNumVisible());
+  EXPECT_EQ(0xff000000 | (uint32_t)nearest, frame_buffer_.Get(32, 24));
+}
@@ -7,14 +7,15 @@ namespace Symphony {
 namespace Math {
 class Circle {
  public:
-  Circle() {}
+  constexpr Circle() {}
 
-  Circle(const Point2d& new_center, float new_radius)
+  constexpr Circle(const Point2d& new_center, float new_radius)
       : center(new_center), radius(new_radius) {}
 
-  bool Intersect(const Circle& circle) const {
+  constexpr bool Intersect(const Circle& circle) const {
     Vector2d v = circle.center - center;
-    if (v.GetLength() > (circle.radius + radius)) {
+    float radius_sum = circle.radius + radius;
+    if (v.GetLengthSq() > radius_sum * radius_sum) {
       return false;
     }
     return true;
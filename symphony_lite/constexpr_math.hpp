@@ -0,0 +1,108 @@
+#pragma once
+
+#include "angle.hpp"
+
+namespace Symphony {
+namespace Math {
+// Compile time versions of sqrtf, sinf, cosf and tanf for baking lookup
+// tables into the binary. Computed in double, so results are within an ulp
+// of the runtime functions. Slow, don't call them at runtime.
+namespace Constexpr {
+constexpr float Abs(float v) { return v < 0.0f ? -v : v; }
+
+constexpr float Sqrt(float v) {
+  if (v <= 0.0f) {
+    return 0.0f;
+  }
+
+  double value = v;
+  double result = value > 1.0 ? value : 1.0;
+  // Newton-Raphson from above decreases monotonically until it converges.
+  for (int i = 0; i < 100; ++i) {
+    double next = 0.5 * (result + value / result);
+    if (next >= result) {
+      break;
+    }
+    result = next;
+  }
+  return (float)result;
+}
+
+namespace {
+constexpr double kPiDouble = 3.14159265358979323846;
+
+// Taylor series, converges fast for |x| <= pi / 4.
+constexpr double sinReduced(double x) {
+  double x_sq = x * x;
+  double term = x;
+  double result = x;
+  for (int i = 1; i < 12; ++i) {
+    term *= -x_sq / ((2 * i) * (2 * i + 1));
+    result += term;
+  }
+  return result;
+}
+
+constexpr double cosReduced(double x) {
+  double x_sq = x * x;
+  double term = 1.0;
+  double result = 1.0;
+  for (int i = 1; i < 12; ++i) {
+    term *= -x_sq / ((2 * i - 1) * (2 * i));
+    result += term;
+  }
+  return result;
+}
+
+// Returns the quadrant nearest to angle_rad, angle_rad - quadrant * pi / 2
+// goes to reduced_out.
+constexpr long long reduce(double angle_rad, double& reduced_out) {
+  double quarters = angle_rad / (kPiDouble / 2.0);
+  long long quadrant =
+      (long long)(quarters < 0.0 ? quarters - 0.5 : quarters + 0.5);
+  reduced_out = angle_rad - (double)quadrant * (kPiDouble / 2.0);
+  return quadrant;
+}
+}  // namespace
+
+constexpr float Sin(float angle_rad) {
+  double x = 0.0;
+  long long quadrant = reduce(angle_rad, x);
+  switch (((quadrant % 4) + 4) % 4) {
+    case 0:
+      return (float)sinReduced(x);
+    case 1:
+      return (float)cosReduced(x);
+    case 2:
+      return (float)-sinReduced(x);
+    default:
+      return (float)-cosReduced(x);
+  }
+}
+
+constexpr float Cos(float angle_rad) {
+  double x = 0.0;
+  long long quadrant = reduce(angle_rad, x);
+  switch (((quadrant % 4) + 4) % 4) {
+    case 0:
+      return (float)cosReduced(x);
+    case 1:
+      return (float)-sinReduced(x);
+    case 2:
+      return (float)-cosReduced(x);
+    default:
+      return (float)sinReduced(x);
+  }
+}
+
+constexpr float Tan(float angle_rad) {
+  double x = 0.0;
+  long long quadrant = reduce(angle_rad, x);
+  if (quadrant % 2 == 0) {
+    return (float)(sinReduced(x) / cosReduced(x));
+  }
+  return (float)(-cosReduced(x) / sinReduced(x));
+}
+}  // namespace Constexpr
+}  // namespace Math
+}  // namespace Symphony
@@ -0,0 +1,62 @@
+#include "constexpr_math.hpp"
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include <array>
+
+#include "aa_rect2d.hpp"
+#include "angle.hpp"
+#include "point2d.hpp"
+#include "vector2d.hpp"
+
+using namespace Symphony::Math;
+
+namespace {
+template <int kSize>
+constexpr std::array<float, kSize> MakeSinTable() {
+  std::array<float, kSize> result{};
+  for (int i = 0; i < kSize; ++i) {
+    result[i] = Constexpr::Sin(2.0f * kPi * (float)i / (float)kSize);
+  }
+  return result;
+}
+
+constexpr std::array<float, 256> kSinTable = MakeSinTable<256>();
+}  // namespace
+
+TEST(ConstexprMath, MatchesRuntime) {
+  for (float v = 0.0f; v < 1000.0f; v += 0.37f) {
+    ASSERT_NEAR(sqrtf(v), Constexpr::Sqrt(v), sqrtf(v) * 1e-6f);
+  }
+  for (float a = -20.0f; a < 20.0f; a += 0.01f) {
+    ASSERT_NEAR(sinf(a), Constexpr::Sin(a), 1e-6f);
+    ASSERT_NEAR(cosf(a), Constexpr::Cos(a), 1e-6f);
+  }
+  for (float a = -1.5f; a < 1.5f; a += 0.01f) {
+    ASSERT_NEAR(tanf(a), Constexpr::Tan(a), fabsf(tanf(a)) * 1e-5f + 1e-6f);
+  }
+}
+
+TEST(ConstexprMath, Tables) {
+  static_assert(Constexpr::Sqrt(16.0f) == 4.0f);
+  static_assert(Constexpr::Abs(kSinTable[64] - 1.0f) < 1e-6f);
+
+  for (int i = 0; i < 256; ++i) {
+    ASSERT_NEAR(sinf(2.0f * kPi * (float)i / 256.0f), kSinTable[i], 1e-6f);
+  }
+}
+
+TEST(ConstexprMath, Types) {
+  constexpr AARect2d rect(Point2d(1.0f, 2.0f), Vector2d(3.0f, 4.0f));
+  static_assert(rect.TopRight().x == 4.0f);
+  static_assert(rect.IsPointInside(Point2d(0.0f, 0.0f)));
+  static_assert(rect.GetMerged(AARect2d(Point2d(10.0f, 2.0f),
+                                        Vector2d(1.0f, 1.0f)))
+                    .half_size.x == 6.5f);
+
+  constexpr Vector2d v = Vector2d(1.0f, 0.0f).GetRotated(
+      Constexpr::Cos(DegToRad(90.0f)), Constexpr::Sin(DegToRad(90.0f)));
+  static_assert(Constexpr::Abs(v.y - 1.0f) < 1e-6f);
+  static_assert((Point2d(1.0f, 1.0f) - Point2d(0.0f, 1.0f)) * v < 1e-6f);
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <math.h>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "aa_rect2d.hpp"
+#include "circle.hpp"
+#include "point2d.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Collision {
+struct ContactManifold {
+  /// Unit vector from a to b, moving b along it by depth separates shapes.
+  Math::Vector2d normal;
+  float depth{0.0f};
+  int num_points{0};
+  Math::Point2d points[2];
+};
+
+inline std::optional<ContactManifold> Collide(const Math::AARect2d& a,
+                                              const Math::AARect2d& b) {
+  std::optional<Math::AARect2d> overlap = a.IntersectRectangle(b);
+  if (!overlap.has_value()) {
+    return std::nullopt;
+  }
+
+  // Per axis, b leaves a by moving towards whichever side is closer. That
+  // is not the overlap size when one box spans the other along the axis.
+  // The cheaper axis wins, the contact face is the overlap side b moves
+  // towards.
+  Math::Point2d a_min = a.BottomLeft();
+  Math::Point2d a_max = a.TopRight();
+  Math::Point2d b_min = b.BottomLeft();
+  Math::Point2d b_max = b.TopRight();
+  float depth_right = a_max.x - b_min.x;
+  float depth_left = b_max.x - a_min.x;
+  float depth_up = a_max.y - b_min.y;
+  float depth_down = b_max.y - a_min.y;
+  float depth_x = std::min(depth_right, depth_left);
+  float depth_y = std::min(depth_up, depth_down);
+
+  ContactManifold result;
+  result.num_points = 2;
+  Math::Point2d bottom_left = overlap->BottomLeft();
+  Math::Point2d top_right = overlap->TopRight();
+  if (depth_x < depth_y) {
+    result.depth = depth_x;
+    if (depth_left < depth_right) {
+      result.normal = Math::Vector2d(-1.0f, 0.0f);
+      result.points[0] = Math::Point2d(bottom_left.x, bottom_left.y);
+      result.points[1] = Math::Point2d(bottom_left.x, top_right.y);
+    } else {
+      result.normal = Math::Vector2d(1.0f, 0.0f);
+      result.points[0] = Math::Point2d(top_right.x, bottom_left.y);
+      result.points[1] = Math::Point2d(top_right.x, top_right.y);
+    }
+  } else {
+    result.depth = depth_y;
+    if (depth_down < depth_up) {
+      result.normal = Math::Vector2d(0.0f, -1.0f);
+      result.points[0] = Math::Point2d(bottom_left.x, bottom_left.y);
+      result.points[1] = Math::Point2d(top_right.x, bottom_left.y);
+    } else {
+      result.normal = Math::Vector2d(0.0f, 1.0f);
+      result.points[0] = Math::Point2d(bottom_left.x, top_right.y);
+      result.points[1] = Math::Point2d(top_right.x, top_right.y);
+    }
+  }
+  return result;
+}
+
+inline std::optional<ContactManifold> Collide(const Math::Circle& a,
+                                              const Math::Circle& b) {
+  Math::Vector2d v = b.center - a.center;
+  float radius_sum = a.radius + b.radius;
+  float distance_sq = v.GetLengthSq();
+  if (distance_sq > radius_sum * radius_sum) {
+    return std::nullopt;
+  }
+
+  ContactManifold result;
+  result.num_points = 1;
+
+  float distance = sqrtf(distance_sq);
+  if (distance < Math::eps) {
+    result.normal = Math::Vector2d::X();
+  } else {
+    result.normal = v * (1.0f / distance);
+  }
+  result.depth = radius_sum - distance;
+  result.points[0] =
+      a.center + result.normal * (a.radius - result.depth * 0.5f);
+  return result;
+}
+
+inline std::optional<ContactManifold> Collide(const Math::Circle& a,
+                                              const Math::AARect2d& b) {
+  Math::Point2d bottom_left = b.BottomLeft();
+  Math::Point2d top_right = b.TopRight();
+  Math::Point2d closest(std::clamp(a.center.x, bottom_left.x, top_right.x),
+                        std::clamp(a.center.y, bottom_left.y, top_right.y));
+
+  Math::Vector2d v = closest - a.center;
+  float distance_sq = v.GetLengthSq();
+  if (distance_sq > a.radius * a.radius) {
+    return std::nullopt;
+  }
+
+  ContactManifold result;
+  result.num_points = 1;
+
+  if (distance_sq > Math::eps * Math::eps) {
+    float distance = sqrtf(distance_sq);
+    result.normal = v * (1.0f / distance);
+    result.depth = a.radius - distance;
+    result.points[0] = closest;
+    return result;
+  }
+
+  // Center is inside, push out through the nearest side.
+  float to_left = a.center.x - bottom_left.x;
+  float to_right = top_right.x - a.center.x;
+  float to_bottom = a.center.y - bottom_left.y;
+  float to_top = top_right.y - a.center.y;
+  float nearest = std::min(std::min(to_left, to_right),
+                           std::min(to_bottom, to_top));
+  if (nearest == to_left) {
+    result.normal = Math::Vector2d(1.0f, 0.0f);
+    result.points[0] = Math::Point2d(bottom_left.x, a.center.y);
+  } else if (nearest == to_right) {
+    result.normal = Math::Vector2d(-1.0f, 0.0f);
+    result.points[0] = Math::Point2d(top_right.x, a.center.y);
+  } else if (nearest == to_bottom) {
+    result.normal = Math::Vector2d(0.0f, 1.0f);
+    result.points[0] = Math::Point2d(a.center.x, bottom_left.y);
+  } else {
+    result.normal = Math::Vector2d(0.0f, -1.0f);
+    result.points[0] = Math::Point2d(a.center.x, top_right.y);
+  }
+  result.depth = a.radius + nearest;
+  return result;
+}
+
+struct ContactPair {
+  int body_a{0};
+  int body_b{0};
+  ContactManifold manifold;
+};
+
+struct PositionSolverParameters {
+  int num_iterations{4};
+  /// Penetration left unresolved, keeps resting contacts from jittering.
+  float slop{0.01f};
+  /// Fraction of the penetration resolved per iteration.
+  float correction_factor{0.8f};
+};
+
+/// Pushes bodies apart along contact normals, Gauss-Seidel over all pairs.
+/// Depths are updated from the corrections made so far, so manifolds are
+/// computed once per frame.
+/// \arg inverse_masses Zero for static bodies.
+inline void SolvePositions(const std::vector<ContactPair>& pairs,
+                           const std::vector<float>& inverse_masses,
+                           const PositionSolverParameters& parameters,
+                           std::vector<Math::Point2d>& positions) {
+  std::vector<Math::Vector2d> corrections(positions.size());
+
+  for (int iteration = 0; iteration < parameters.num_iterations;
+       ++iteration) {
+    for (const ContactPair& pair : pairs) {
+      float inverse_mass_a = inverse_masses[pair.body_a];
+      float inverse_mass_b = inverse_masses[pair.body_b];
+      float inverse_mass_sum = inverse_mass_a + inverse_mass_b;
+      if (inverse_mass_sum == 0.0f) {
+        continue;
+      }
+
+      const Math::Vector2d& normal = pair.manifold.normal;
+      float depth =
+          pair.manifold.depth -
+          (corrections[pair.body_b] - corrections[pair.body_a]) * normal;
+      float correction = std::max(depth - parameters.slop, 0.0f) *
+                         parameters.correction_factor / inverse_mass_sum;
+      if (correction == 0.0f) {
+        continue;
+      }
+
+      corrections[pair.body_a] =
+          corrections[pair.body_a] - normal * (correction * inverse_mass_a);
+      corrections[pair.body_b] =
+          corrections[pair.body_b] + normal * (correction * inverse_mass_b);
+    }
+  }
+
+  for (int i = 0; i < (int)positions.size(); ++i) {
+    positions[i] = positions[i] + corrections[i];
+  }
+}
+}  // namespace Collision
+}  // namespace Symphony
@@ -0,0 +1,123 @@
+#include "contact_manifold.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Symphony::Collision;
+using namespace Symphony::Math;
+
+TEST(ContactManifold, AARect2dAARect2d) {
+  AARect2d a(Point2d(0.0f, 0.0f), Vector2d(2.0f, 2.0f));
+  AARect2d b(Point2d(3.5f, 1.0f), Vector2d(2.0f, 2.0f));
+
+  auto manifold = Collide(a, b);
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(1.0f, manifold->normal.x, eps);
+  ASSERT_NEAR(0.0f, manifold->normal.y, eps);
+  ASSERT_NEAR(0.5f, manifold->depth, eps);
+  ASSERT_EQ(2, manifold->num_points);
+  ASSERT_NEAR(2.0f, manifold->points[0].x, eps);
+  ASSERT_NEAR(-1.0f, manifold->points[0].y, eps);
+  ASSERT_NEAR(2.0f, manifold->points[1].x, eps);
+  ASSERT_NEAR(2.0f, manifold->points[1].y, eps);
+
+  manifold = Collide(a, AARect2d(Point2d(1.0f, -3.0f), Vector2d(2.0f, 2.0f)));
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(0.0f, manifold->normal.x, eps);
+  ASSERT_NEAR(-1.0f, manifold->normal.y, eps);
+  ASSERT_NEAR(1.0f, manifold->depth, eps);
+
+  ASSERT_FALSE(
+      Collide(a, AARect2d(Point2d(5.0f, 0.0f), Vector2d(2.0f, 2.0f)))
+          .has_value());
+}
+
+TEST(ContactManifold, AARect2dContained) {
+  // a = [0, 10]^2, b = [4, 6] x [7, 12]: the overlap is 2 x 3, but along x
+  // b is inside of a and needs 6 to get out.
+  AARect2d a(Point2d(5.0f, 5.0f), Vector2d(5.0f, 5.0f));
+  AARect2d b(Point2d(5.0f, 9.5f), Vector2d(1.0f, 2.5f));
+
+  auto manifold = Collide(a, b);
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(0.0f, manifold->normal.x, eps);
+  ASSERT_NEAR(1.0f, manifold->normal.y, eps);
+  ASSERT_NEAR(3.0f, manifold->depth, eps);
+  ASSERT_NEAR(10.0f, manifold->points[0].y, eps);
+  ASSERT_NEAR(10.0f, manifold->points[1].y, eps);
+
+  // Same centers, the closer side still decides.
+  manifold = Collide(a, AARect2d(Point2d(5.0f, 5.0f), Vector2d(4.0f, 1.0f)));
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(1.0f, manifold->normal.y * manifold->normal.y, eps);
+  ASSERT_NEAR(6.0f, manifold->depth, eps);
+
+  manifold = Collide(a, AARect2d(Point2d(2.0f, 5.0f), Vector2d(1.0f, 1.0f)));
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(-1.0f, manifold->normal.x, eps);
+  ASSERT_NEAR(3.0f, manifold->depth, eps);
+}
+
+TEST(ContactManifold, CircleCircle) {
+  auto manifold = Collide(Circle(Point2d(0.0f, 0.0f), 2.0f),
+                          Circle(Point2d(0.0f, 3.0f), 2.0f));
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(0.0f, manifold->normal.x, eps);
+  ASSERT_NEAR(1.0f, manifold->normal.y, eps);
+  ASSERT_NEAR(1.0f, manifold->depth, eps);
+  ASSERT_EQ(1, manifold->num_points);
+  ASSERT_NEAR(1.5f, manifold->points[0].y, eps);
+
+  ASSERT_FALSE(Collide(Circle(Point2d(0.0f, 0.0f), 2.0f),
+                       Circle(Point2d(0.0f, 5.0f), 2.0f))
+                   .has_value());
+}
+
+TEST(ContactManifold, CircleAARect2d) {
+  AARect2d rect(Point2d(0.0f, 0.0f), Vector2d(2.0f, 1.0f));
+
+  auto manifold = Collide(Circle(Point2d(0.0f, 1.5f), 1.0f), rect);
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(0.0f, manifold->normal.x, eps);
+  ASSERT_NEAR(-1.0f, manifold->normal.y, eps);
+  ASSERT_NEAR(0.5f, manifold->depth, eps);
+  ASSERT_NEAR(0.0f, manifold->points[0].x, eps);
+  ASSERT_NEAR(1.0f, manifold->points[0].y, eps);
+
+  // Center inside, nearest side is the right one.
+  manifold = Collide(Circle(Point2d(1.5f, 0.0f), 1.0f), rect);
+  ASSERT_TRUE(manifold.has_value());
+  ASSERT_NEAR(-1.0f, manifold->normal.x, eps);
+  ASSERT_NEAR(1.5f, manifold->depth, eps);
+
+  ASSERT_FALSE(Collide(Circle(Point2d(3.0f, 2.0f), 1.0f), rect).has_value());
+}
+
+TEST(ContactManifold, SolvePositions) {
+  // Box resting on static ground and a second box stacked on it.
+  std::vector<Point2d> positions = {Point2d(0.0f, -1.0f), Point2d(0.0f, 0.8f),
+                                    Point2d(0.0f, 2.6f)};
+  std::vector<Vector2d> half_sizes = {Vector2d(10.0f, 1.0f),
+                                      Vector2d(1.0f, 1.0f),
+                                      Vector2d(1.0f, 1.0f)};
+  std::vector<float> inverse_masses = {0.0f, 1.0f, 1.0f};
+
+  PositionSolverParameters parameters;
+  parameters.num_iterations = 10;
+  for (int frame = 0; frame < 10; ++frame) {
+    std::vector<ContactPair> pairs;
+    for (int a = 0; a < (int)positions.size(); ++a) {
+      for (int b = a + 1; b < (int)positions.size(); ++b) {
+        auto manifold = Collide(AARect2d(positions[a], half_sizes[a]),
+                                AARect2d(positions[b], half_sizes[b]));
+        if (manifold.has_value()) {
+          pairs.push_back(ContactPair{a, b, manifold.value()});
+        }
+      }
+    }
+    SolvePositions(pairs, inverse_masses, parameters, positions);
+  }
+
+  ASSERT_EQ(-1.0f, positions[0].y);
+  ASSERT_NEAR(1.0f, positions[1].y, parameters.slop * 2.0f);
+  ASSERT_NEAR(3.0f, positions[2].y, parameters.slop * 4.0f);
+}
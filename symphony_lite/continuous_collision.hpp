@@ -0,0 +1,244 @@
+#pragma once
+
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+#include "aa_rect2d.hpp"
+#include "circle.hpp"
+#include "point2d.hpp"
+#include "segment2d.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Collision {
+// Time of impact queries for a shape moving along displacement against a
+// static target. Every query reduces to a ray cast against the target grown
+// by the moving shape (Minkowski sum), so fast movers can't tunnel through
+// thin walls without substeps.
+struct TimeOfImpact {
+  /// Fraction of displacement in [0, 1] at which shapes touch. Zero when they
+  /// already overlap.
+  float time{0.0f};
+  /// Unit vector pointing from target to moving shape.
+  Math::Vector2d normal;
+};
+
+namespace {
+std::optional<float> rayCircleTime(const Math::Point2d& ray_start,
+                                   const Math::Vector2d& displacement,
+                                   const Math::Point2d& center, float radius) {
+  Math::Vector2d m = ray_start - center;
+  float c = m.GetLengthSq() - radius * radius;
+  if (c <= 0.0f) {
+    return 0.0f;
+  }
+
+  float a = displacement.GetLengthSq();
+  float b = m * displacement;
+  if (b >= 0.0f || a == 0.0f) {
+    return std::nullopt;
+  }
+
+  float discriminant = b * b - a * c;
+  if (discriminant < 0.0f) {
+    return std::nullopt;
+  }
+
+  float time = (-b - sqrtf(discriminant)) / a;
+  if (time > 1.0f) {
+    return std::nullopt;
+  }
+  return std::max(time, 0.0f);
+}
+
+// Keeps the earliest of the two impacts.
+void keepEarliest(const std::optional<TimeOfImpact>& candidate,
+                  std::optional<TimeOfImpact>& result) {
+  if (candidate.has_value() &&
+      (!result.has_value() || candidate->time < result->time)) {
+    result = candidate;
+  }
+}
+}  // namespace
+
+inline std::optional<TimeOfImpact> SweepAARect2d(
+    const Math::AARect2d& moving, const Math::Vector2d& displacement,
+    const Math::AARect2d& target) {
+  Math::Vector2d half_size = target.half_size + moving.half_size;
+  Math::Vector2d to_moving = moving.center - target.center;
+
+  if (fabsf(to_moving.x) < half_size.x && fabsf(to_moving.y) < half_size.y) {
+    // Already overlap, push out along the axis of least penetration.
+    TimeOfImpact result;
+    float penetration_x = half_size.x - fabsf(to_moving.x);
+    float penetration_y = half_size.y - fabsf(to_moving.y);
+    if (penetration_x < penetration_y) {
+      result.normal = Math::Vector2d(to_moving.x < 0.0f ? -1.0f : 1.0f, 0.0f);
+    } else {
+      result.normal = Math::Vector2d(0.0f, to_moving.y < 0.0f ? -1.0f : 1.0f);
+    }
+    return result;
+  }
+
+  float time_enter = -std::numeric_limits<float>::infinity();
+  float time_exit = 1.0f;
+  Math::Vector2d normal;
+
+  if (displacement.x == 0.0f) {
+    if (fabsf(to_moving.x) > half_size.x) {
+      return std::nullopt;
+    }
+  } else {
+    float displacement_inv = 1.0f / displacement.x;
+    float t1 = (-half_size.x - to_moving.x) * displacement_inv;
+    float t2 = (half_size.x - to_moving.x) * displacement_inv;
+    time_enter = std::min(t1, t2);
+    time_exit = std::min(time_exit, std::max(t1, t2));
+    normal = Math::Vector2d(displacement.x > 0.0f ? -1.0f : 1.0f, 0.0f);
+  }
+
+  if (displacement.y == 0.0f) {
+    if (fabsf(to_moving.y) > half_size.y) {
+      return std::nullopt;
+    }
+  } else {
+    float displacement_inv = 1.0f / displacement.y;
+    float t1 = (-half_size.y - to_moving.y) * displacement_inv;
+    float t2 = (half_size.y - to_moving.y) * displacement_inv;
+    float axis_enter = std::min(t1, t2);
+    if (axis_enter > time_enter) {
+      time_enter = axis_enter;
+      normal = Math::Vector2d(0.0f, displacement.y > 0.0f ? -1.0f : 1.0f);
+    }
+    time_exit = std::min(time_exit, std::max(t1, t2));
+  }
+
+  // Missed, or the target is behind.
+  if (time_enter > time_exit || time_enter < 0.0f) {
+    return std::nullopt;
+  }
+
+  TimeOfImpact result;
+  result.time = time_enter;
+  result.normal = normal;
+  return result;
+}
+
+inline std::optional<TimeOfImpact> SweepCircle(
+    const Math::Circle& moving, const Math::Vector2d& displacement,
+    const Math::Circle& target) {
+  float radius = moving.radius + target.radius;
+  std::optional<float> time =
+      rayCircleTime(moving.center, displacement, target.center, radius);
+  if (!time.has_value()) {
+    return std::nullopt;
+  }
+
+  TimeOfImpact result;
+  result.time = time.value();
+  result.normal =
+      ((moving.center + displacement * result.time) - target.center);
+  result.normal.MakeNormalized(Math::eps);
+  return result;
+}
+
+inline std::optional<TimeOfImpact> SweepCircle(
+    const Math::Circle& moving, const Math::Vector2d& displacement,
+    const Math::Segment2d& target) {
+  std::optional<TimeOfImpact> result;
+
+  // Segment grown by radius is a capsule: two end caps and two sides.
+  keepEarliest(SweepCircle(moving, displacement, Math::Circle(target.p0, 0.0f)),
+               result);
+  keepEarliest(SweepCircle(moving, displacement, Math::Circle(target.p1, 0.0f)),
+               result);
+
+  Math::Vector2d along = target.p1 - target.p0;
+  float length = along.GetLength();
+  if (length < Math::eps) {
+    return result;
+  }
+
+  Math::Vector2d normal(-along.y / length, along.x / length);
+  float side_distance = (moving.center - target.p0) * normal;
+  if (side_distance < 0.0f) {
+    normal = -normal;
+    side_distance = -side_distance;
+  }
+
+  float along_start = (moving.center - target.p0) * along / (length * length);
+  if (side_distance < moving.radius && along_start >= 0.0f &&
+      along_start <= 1.0f) {
+    TimeOfImpact overlap;
+    overlap.normal = normal;
+    return overlap;
+  }
+
+  float approach_speed = -(displacement * normal);
+  if (approach_speed <= 0.0f) {
+    return result;
+  }
+
+  float time = (side_distance - moving.radius) / approach_speed;
+  if (time < 0.0f || time > 1.0f) {
+    return result;
+  }
+
+  Math::Point2d center = moving.center + displacement * time;
+  float along_hit = (center - target.p0) * along / (length * length);
+  if (along_hit >= 0.0f && along_hit <= 1.0f) {
+    TimeOfImpact side;
+    side.time = time;
+    side.normal = normal;
+    keepEarliest(side, result);
+  }
+
+  return result;
+}
+
+inline std::optional<TimeOfImpact> SweepCircle(
+    const Math::Circle& moving, const Math::Vector2d& displacement,
+    const Math::AARect2d& target) {
+  float left = target.center.x - target.half_size.x;
+  float right = target.center.x + target.half_size.x;
+  float bottom = target.center.y - target.half_size.y;
+  float top = target.center.y + target.half_size.y;
+
+  // Rect grown by radius has rounded corners, first hit its bounding box.
+  Math::AARect2d grown(target.center,
+                       target.half_size +
+                           Math::Vector2d(moving.radius, moving.radius));
+  std::optional<TimeOfImpact> box_hit =
+      SweepAARect2d(Math::AARect2d(moving.center, Math::Vector2d()),
+                    displacement, grown);
+  if (!box_hit.has_value()) {
+    return std::nullopt;
+  }
+
+  Math::Point2d p = moving.center + displacement * box_hit->time;
+  bool outside_x = p.x < left || p.x > right;
+  bool outside_y = p.y < bottom || p.y > top;
+  if (!outside_x || !outside_y) {
+    if (box_hit->time == 0.0f) {
+      // Overlap, normal towards the closest rect side.
+      Math::Point2d closest(std::clamp(p.x, left, right),
+                            std::clamp(p.y, bottom, top));
+      Math::Vector2d to_center = p - closest;
+      if (to_center.GetLengthSq() > Math::eps * Math::eps) {
+        box_hit->normal = to_center.GetNormalized();
+      }
+    }
+    return box_hit;
+  }
+
+  // Entered a corner region, the real surface there is a circle. Missing it
+  // means missing the rect: leaving the corner region towards the rect goes
+  // through the circle.
+  Math::Point2d corner(p.x < left ? left : right, p.y < bottom ? bottom : top);
+  return SweepCircle(moving, displacement, Math::Circle(corner, 0.0f));
+}
+}  // namespace Collision
+}  // namespace Symphony
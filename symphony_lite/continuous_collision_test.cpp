@@ -0,0 +1,100 @@
+#include "continuous_collision.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Symphony::Collision;
+using namespace Symphony::Math;
+
+TEST(ContinuousCollision, SweepAARect2dThroughThinWall) {
+  AARect2d wall(Point2d(10.0f, 0.0f), Vector2d(0.05f, 5.0f));
+  AARect2d bullet(Point2d(0.0f, 0.0f), Vector2d(0.1f, 0.1f));
+
+  // Static test at the end position misses the wall.
+  AARect2d bullet_end(Point2d(20.0f, 0.0f), bullet.half_size);
+  ASSERT_FALSE(wall.Intersect(bullet_end));
+
+  auto toi = SweepAARect2d(bullet, Vector2d(20.0f, 0.0f), wall);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_NEAR(9.85f / 20.0f, toi->time, eps);
+  ASSERT_NEAR(-1.0f, toi->normal.x, eps);
+  ASSERT_NEAR(0.0f, toi->normal.y, eps);
+
+  ASSERT_FALSE(SweepAARect2d(bullet, Vector2d(5.0f, 0.0f), wall).has_value());
+  ASSERT_FALSE(SweepAARect2d(bullet, Vector2d(-20.0f, 0.0f), wall).has_value());
+  ASSERT_FALSE(SweepAARect2d(bullet, Vector2d(20.0f, 20.0f), wall).has_value());
+
+  toi = SweepAARect2d(AARect2d(Point2d(10.0f, 10.0f), bullet.half_size),
+                      Vector2d(0.0f, -10.0f), wall);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_NEAR(4.9f / 10.0f, toi->time, eps);
+  ASSERT_NEAR(1.0f, toi->normal.y, eps);
+
+  toi = SweepAARect2d(AARect2d(Point2d(10.0f, 0.0f), bullet.half_size),
+                      Vector2d(1.0f, 0.0f), wall);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_EQ(0.0f, toi->time);
+}
+
+TEST(ContinuousCollision, SweepCircleCircle) {
+  Circle moving(Point2d(0.0f, 0.0f), 1.0f);
+  Circle target(Point2d(10.0f, 0.0f), 2.0f);
+
+  auto toi = SweepCircle(moving, Vector2d(20.0f, 0.0f), target);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_NEAR(7.0f / 20.0f, toi->time, eps);
+  ASSERT_NEAR(-1.0f, toi->normal.x, eps);
+
+  ASSERT_FALSE(SweepCircle(moving, Vector2d(0.0f, 20.0f), target).has_value());
+}
+
+TEST(ContinuousCollision, SweepCircleSegment) {
+  Segment2d wall(Point2d(5.0f, -5.0f), Point2d(5.0f, 5.0f));
+  Circle bullet(Point2d(0.0f, 0.0f), 0.5f);
+
+  auto toi = SweepCircle(bullet, Vector2d(10.0f, 0.0f), wall);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_NEAR(4.5f / 10.0f, toi->time, eps);
+  ASSERT_NEAR(-1.0f, toi->normal.x, eps);
+  ASSERT_NEAR(0.0f, toi->normal.y, eps);
+
+  // Hits the end cap.
+  toi = SweepCircle(Circle(Point2d(0.0f, 5.3f), 0.5f), Vector2d(10.0f, 0.0f),
+                    wall);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_NEAR((5.0f - 0.4f) / 10.0f, toi->time, eps);
+  ASSERT_NEAR(-0.8f, toi->normal.x, eps);
+  ASSERT_NEAR(0.6f, toi->normal.y, eps);
+
+  ASSERT_FALSE(SweepCircle(Circle(Point2d(0.0f, 6.0f), 0.5f),
+                           Vector2d(10.0f, 0.0f), wall)
+                   .has_value());
+  ASSERT_FALSE(SweepCircle(bullet, Vector2d(4.0f, 0.0f), wall).has_value());
+}
+
+TEST(ContinuousCollision, SweepCircleAARect2d) {
+  AARect2d box(Point2d(10.0f, 0.0f), Vector2d(1.0f, 1.0f));
+
+  auto toi = SweepCircle(Circle(Point2d(0.0f, 0.0f), 0.5f),
+                         Vector2d(20.0f, 0.0f), box);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_NEAR(8.5f / 20.0f, toi->time, eps);
+  ASSERT_NEAR(-1.0f, toi->normal.x, eps);
+
+  // Hits the rounded corner.
+  toi = SweepCircle(Circle(Point2d(0.0f, 1.3f), 0.5f), Vector2d(20.0f, 0.0f),
+                    box);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_NEAR((9.0f - 0.4f) / 20.0f, toi->time, eps);
+  ASSERT_NEAR(-0.8f, toi->normal.x, eps);
+  ASSERT_NEAR(0.6f, toi->normal.y, eps);
+
+  // Passes by the rounded corner, a box grown by the radius would be hit.
+  ASSERT_FALSE(SweepCircle(Circle(Point2d(0.0f, -7.1f), 0.5f),
+                           Vector2d(20.0f, 20.0f), box)
+                   .has_value());
+
+  toi = SweepCircle(Circle(Point2d(10.0f, 0.0f), 0.5f), Vector2d(1.0f, 0.0f),
+                    box);
+  ASSERT_TRUE(toi.has_value());
+  ASSERT_EQ(0.0f, toi->time);
+}
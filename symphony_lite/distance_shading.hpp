@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace Symphony {
+namespace Visibility {
+// Fog by distance for software renderers without float math per pixel.
+// Depth is quantized to a few levels once per span, pixels then go through
+// lookup tables: per channel for 0xAARRGGBB colors, per palette index for
+// 8 bit indexed frame buffers.
+class DistanceShading {
+ public:
+  static constexpr int kNumLevels = 32;
+
+  /// \arg fog_start Closer pixels keep their color.
+  /// \arg fog_end Farther pixels are fog_color.
+  DistanceShading(float fog_start, float fog_end, uint32_t fog_color)
+      : level_scale_((float)kNumLevels / fog_end),
+        channel_tables_(kNumLevels * 3 * 256) {
+    for (int level = 0; level < kNumLevels; ++level) {
+      // Level center, so the average error is zero.
+      float depth = ((float)level + 0.5f) / level_scale_;
+      float fog = std::clamp((depth - fog_start) / (fog_end - fog_start),
+                             0.0f, 1.0f);
+      if (level == kNumLevels - 1) {
+        fog = 1.0f;
+      }
+      for (int channel = 0; channel < 3; ++channel) {
+        float fog_value = (float)((fog_color >> (channel * 8)) & 0xff);
+        uint8_t* table = getChannelTable(level, channel);
+        for (int value = 0; value < 256; ++value) {
+          table[value] = (uint8_t)((float)value +
+                                   ((fog_value - (float)value) * fog) + 0.5f);
+        }
+      }
+    }
+  }
+
+  /// Builds the tables for 8 bit frame buffers: entry i shaded to a level
+  /// maps to the closest palette color. Only the first 256 entries are
+  /// used, 8 bit pixels can't index more.
+  void SetPalette(const std::vector<uint32_t>& palette) {
+    int size = std::min((int)palette.size(), 256);
+    index_tables_.assign(kNumLevels * 256, 0);
+    for (int level = 0; level < kNumLevels; ++level) {
+      for (int index = 0; index < size; ++index) {
+        index_tables_[level * 256 + index] =
+            findClosest(palette, size, ShadeColor(palette[index], level));
+      }
+    }
+  }
+
+  /// Level for a depth along the camera direction.
+  int GetLevel(float depth) const {
+    return std::clamp((int)(depth * level_scale_), 0, kNumLevels - 1);
+  }
+
+  uint32_t ShadeColor(uint32_t color, int level) const {
+    const uint8_t* blue = getChannelTable(level, 0);
+    const uint8_t* green = getChannelTable(level, 1);
+    const uint8_t* red = getChannelTable(level, 2);
+    return (color & 0xff000000) | ((uint32_t)red[(color >> 16) & 0xff] << 16) |
+           ((uint32_t)green[(color >> 8) & 0xff] << 8) |
+           (uint32_t)blue[color & 0xff];
+  }
+
+  /// Span at one depth, like a wall column.
+  void ShadeSpan(uint32_t* pixels, int size, int level) const {
+    for (int i = 0; i < size; ++i) {
+      pixels[i] = ShadeColor(pixels[i], level);
+    }
+  }
+
+  /// Span with a level per pixel, like floor rows.
+  void ShadeSpan(uint32_t* pixels, int size, const uint8_t* levels) const {
+    for (int i = 0; i < size; ++i) {
+      pixels[i] = ShadeColor(pixels[i], levels[i]);
+    }
+  }
+
+  /// Indexed versions, SetPalette must have been called.
+  void ShadeSpan(uint8_t* pixels, int size, int level) const {
+    const uint8_t* table = index_tables_.data() + level * 256;
+    for (int i = 0; i < size; ++i) {
+      pixels[i] = table[pixels[i]];
+    }
+  }
+
+  void ShadeSpan(uint8_t* pixels, int size, const uint8_t* levels) const {
+    for (int i = 0; i < size; ++i) {
+      pixels[i] = index_tables_[levels[i] * 256 + pixels[i]];
+    }
+  }
+
+ private:
+  uint8_t* getChannelTable(int level, int channel) {
+    return channel_tables_.data() + (level * 3 + channel) * 256;
+  }
+
+  const uint8_t* getChannelTable(int level, int channel) const {
+    return channel_tables_.data() + (level * 3 + channel) * 256;
+  }
+
+  // Among the first size entries.
+  static uint8_t findClosest(const std::vector<uint32_t>& palette, int size,
+                             uint32_t color) {
+    int best = 0;
+    int best_distance = 0x7fffffff;
+    for (int i = 0; i < size; ++i) {
+      int distance = 0;
+      for (int shift = 0; shift < 24; shift += 8) {
+        int d = (int)((palette[i] >> shift) & 0xff) -
+                (int)((color >> shift) & 0xff);
+        distance += d * d;
+      }
+      if (distance < best_distance) {
+        best = i;
+        best_distance = distance;
+      }
+    }
+    return (uint8_t)best;
+  }
+
+  float level_scale_;
+  // kNumLevels x (blue, green, red) x 256.
+  std::vector<uint8_t> channel_tables_;
+  // kNumLevels x 256.
+  std::vector<uint8_t> index_tables_;
+};
+}  // namespace Visibility
+}  // namespace Symphony
@@ -0,0 +1,122 @@
+#include "distance_shading.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ray_casting_renderer.hpp"
+
+using namespace Symphony::Math;
+using namespace Symphony::Visibility;
+
+TEST(DistanceShading, Levels) {
+  DistanceShading shading(/* fog_start= */ 4.0f, /* fog_end= */ 16.0f,
+                          0xff000000);
+  EXPECT_EQ(0, shading.GetLevel(-1.0f));
+  EXPECT_EQ(0, shading.GetLevel(0.0f));
+  EXPECT_EQ(2, shading.GetLevel(1.0f));
+  EXPECT_EQ(16, shading.GetLevel(8.0f));
+  EXPECT_EQ(DistanceShading::kNumLevels - 1, shading.GetLevel(100.0f));
+}
+
+TEST(DistanceShading, Rgba) {
+  const uint32_t kFogColor = 0xff8040c0;
+  DistanceShading shading(4.0f, 16.0f, kFogColor);
+
+  // Alpha is kept, channels move towards the fog.
+  EXPECT_EQ(0x80ffffffu, shading.ShadeColor(0x80ffffff, shading.GetLevel(1)));
+  EXPECT_EQ(0x80000000u | (kFogColor & 0xffffff),
+            shading.ShadeColor(0x80ffffff, shading.GetLevel(20.0f)));
+  uint32_t halfway = shading.ShadeColor(0xff000000, shading.GetLevel(10.0f));
+  EXPECT_NEAR(0x40, (int)(halfway >> 16) & 0xff, 4);
+  EXPECT_NEAR(0x20, (int)(halfway >> 8) & 0xff, 4);
+  EXPECT_NEAR(0x60, (int)halfway & 0xff, 4);
+
+  std::vector<uint32_t> span(5, 0xffffffff);
+  std::vector<uint8_t> levels = {0, 8, 16, 24, 31};
+  shading.ShadeSpan(span.data(), 5, levels.data());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(shading.ShadeColor(0xffffffff, levels[i]), span[i]);
+  }
+  shading.ShadeSpan(span.data(), 2, 31);
+  EXPECT_EQ(kFogColor, span[0]);
+  EXPECT_EQ(kFogColor, span[1]);
+  EXPECT_EQ(shading.ShadeColor(0xffffffff, 16), span[2]);
+}
+
+TEST(DistanceShading, Indexed) {
+  // Gray ramp.
+  std::vector<uint32_t> palette;
+  for (int i = 0; i < 256; ++i) {
+    palette.push_back(0xff000000 | (uint32_t)i * 0x010101);
+  }
+  DistanceShading shading(0.0f, 8.0f, 0xff000000);
+  shading.SetPalette(palette);
+
+  std::vector<uint8_t> span = {255, 255, 255, 100};
+  shading.ShadeSpan(span.data(), 4, 0);
+  EXPECT_EQ(251, span[0]);
+  shading.ShadeSpan(span.data(), 4, DistanceShading::kNumLevels - 1);
+  for (uint8_t index : span) {
+    EXPECT_EQ(0, index);
+  }
+
+  std::vector<uint8_t> ramp = {200, 200};
+  std::vector<uint8_t> levels = {0, 16};
+  shading.ShadeSpan(ramp.data(), 2, levels.data());
+  EXPECT_EQ(197, ramp[0]);
+  EXPECT_EQ(97, ramp[1]);
+}
+
+TEST(DistanceShading, PaletteOver256Entries) {
+  std::vector<uint32_t> palette;
+  for (int i = 0; i < 256; ++i) {
+    palette.push_back(0xff000000 | (uint32_t)i * 0x010101);
+  }
+  DistanceShading expected(0.0f, 8.0f, 0xffff0000);
+  expected.SetPalette(palette);
+
+  // Entries past 255 are ignored, even when they match better.
+  for (int i = 0; i < 44; ++i) {
+    palette.push_back(0xffff0000);
+  }
+  DistanceShading shading(0.0f, 8.0f, 0xffff0000);
+  shading.SetPalette(palette);
+
+  for (int level = 0; level < DistanceShading::kNumLevels; ++level) {
+    for (int index = 0; index < 256; ++index) {
+      uint8_t pixel = (uint8_t)index;
+      uint8_t expected_pixel = (uint8_t)index;
+      shading.ShadeSpan(&pixel, 1, level);
+      expected.ShadeSpan(&expected_pixel, 1, level);
+      ASSERT_EQ(expected_pixel, pixel);
+    }
+  }
+}
+
+TEST(DistanceShading, RayCastingRenderer) {
+  TileMap map(8, 8);
+  for (int i = 0; i < 8; ++i) {
+    map.Set(i, 7, 1);
+  }
+  Image wall(4, 4);
+  std::fill(wall.pixels.begin(), wall.pixels.end(), 0xffffffff);
+  std::vector<Image> textures = {wall};
+
+  RayCastingProjection projection(64, 48, 90.0f);
+  projection.SetCamera(Point2d(4.5f, 1.5f), 0.5f, Vector2d(0.0f, 1.0f));
+  DistanceShading shading(0.0f, 11.0f, 0xff000000);
+  RayCastingParameters parameters;
+  parameters.floor_color = 0xffffffff;
+  parameters.shading = &shading;
+  Image frame_buffer(64, 48);
+  RayCastingRenderer renderer;
+  renderer.Render(projection, map, textures, parameters, frame_buffer);
+
+  // Wall 5.5 away, at the center of level 16.
+  EXPECT_EQ(shading.ShadeColor(0xffffffff, 16), frame_buffer.Get(32, 24));
+  // Floor gets darker towards the horizon.
+  uint32_t near_floor = frame_buffer.Get(32, 47) & 0xff;
+  uint32_t far_floor = frame_buffer.Get(32, 30) & 0xff;
+  EXPECT_GT(near_floor, far_floor);
+}
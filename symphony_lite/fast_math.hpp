@@ -0,0 +1,252 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <array>
+#include <bit>
+
+#include "angle.hpp"
+#include "constexpr_math.hpp"
+#include "simd.hpp"
+
+namespace Symphony {
+namespace Math {
+// Cheaper replacements for sinf, cosf, atan2f, 1 / sqrtf and 1 / x for
+// per-ray and per-particle math on slow FPUs. Pick the tier per call site.
+namespace Fast {
+enum class Accuracy {
+  /// Standard library, for comparisons and switching tiers off.
+  kExact,
+  /// Absolute error about 1e-4 or better, polynomials and Newton steps.
+  kHigh,
+  /// Absolute error about 1e-2 or better, tables and single estimates.
+  /// The array Sin uses the short polynomial for every element instead of
+  /// the table, lanes can't gather.
+  kLow,
+};
+
+namespace {
+constexpr int kSinTableSize = 1024;
+
+constexpr std::array<float, kSinTableSize> makeSinTable() {
+  std::array<float, kSinTableSize> result{};
+  for (int i = 0; i < kSinTableSize; ++i) {
+    result[i] =
+        Constexpr::Sin(2.0f * kPi * (float)i / (float)kSinTableSize);
+  }
+  return result;
+}
+
+// 4KB, baked into the binary.
+constexpr std::array<float, kSinTableSize> kSinTable = makeSinTable();
+
+// Nearest table entry, error is at most half a step: pi / 1024.
+inline float sinTable(float angle_rad, int quarter_offset) {
+  float t = angle_rad * ((float)kSinTableSize / (2.0f * kPi));
+  int index = (int)(t >= 0.0f ? t + 0.5f : t - 0.5f);
+  index += quarter_offset * (kSinTableSize / 4);
+  return kSinTable[index & (kSinTableSize - 1)];
+}
+
+// Odd polynomial for x in [-pi / 2, pi / 2]. Taylor up to x^9 for kHigh
+// (error 4e-6), up to x^5 for kLow (error 5e-3).
+template <Accuracy kAccuracy, typename T>
+T sinPolynomial(T x) {
+  T x_sq = x * x;
+  if constexpr (kAccuracy == Accuracy::kLow) {
+    return x * (T(1.0f) +
+                x_sq * (T(-1.0f / 6.0f) + x_sq * T(1.0f / 120.0f)));
+  } else {
+    return x *
+           (T(1.0f) +
+            x_sq * (T(-1.0f / 6.0f) +
+                    x_sq * (T(1.0f / 120.0f) +
+                            x_sq * (T(-1.0f / 5040.0f) +
+                                    x_sq * T(1.0f / 362880.0f)))));
+  }
+}
+
+// Wraps to [-pi, pi] and folds into [-pi / 2, pi / 2] keeping sin, without
+// branches so it works lane wise.
+template <typename T, typename RoundFn, typename MinFn, typename MaxFn>
+T foldSinArgument(T x, RoundFn round, MinFn min, MaxFn max) {
+  x = x - T(2.0f * kPi) * round(x * T(0.5f * kPiInv));
+  return max(min(x, T(kPi) - x), T(-kPi) - x);
+}
+
+template <Accuracy kAccuracy>
+float sinFolded(float angle_rad) {
+  float x = foldSinArgument(
+      angle_rad, [](float v) { return rintf(v); },
+      [](float a, float b) { return a < b ? a : b; },
+      [](float a, float b) { return a > b ? a : b; });
+  return sinPolynomial<kAccuracy>(x);
+}
+
+// Keeps the polynomial code above the same for float and Simd::Float.
+struct SimdFloat : Simd::Float {
+  SimdFloat(Simd::Float f) : Simd::Float(f) {}
+  SimdFloat(float value) : Simd::Float(Simd::Float::Set(value)) {}
+};
+}  // namespace
+
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline float Sin(float angle_rad) {
+  if constexpr (kAccuracy == Accuracy::kExact) {
+    return sinf(angle_rad);
+  } else if constexpr (kAccuracy == Accuracy::kLow) {
+    return sinTable(angle_rad, 0);
+  } else {
+    return sinFolded<kAccuracy>(angle_rad);
+  }
+}
+
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline float Cos(float angle_rad) {
+  if constexpr (kAccuracy == Accuracy::kExact) {
+    return cosf(angle_rad);
+  } else if constexpr (kAccuracy == Accuracy::kLow) {
+    return sinTable(angle_rad, 1);
+  } else {
+    return Sin<kAccuracy>(angle_rad + kPi * 0.5f);
+  }
+}
+
+/// Same conventions as atan2f, result is in [-pi, pi].
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline float Atan2(float y, float x) {
+  if constexpr (kAccuracy == Accuracy::kExact) {
+    return atan2f(y, x);
+  } else {
+    float abs_x = fabsf(x);
+    float abs_y = fabsf(y);
+    float max_abs = abs_x > abs_y ? abs_x : abs_y;
+    if (max_abs == 0.0f) {
+      return 0.0f;
+    }
+
+    // atan of z in [0, 1], the rest follows from symmetries.
+    float z = (abs_x < abs_y ? abs_x : abs_y) / max_abs;
+    float result = 0.0f;
+    if constexpr (kAccuracy == Accuracy::kLow) {
+      // Error 1.5e-3.
+      result = kPi * 0.25f * z - z * (z - 1.0f) * (0.2447f + 0.0663f * z);
+    } else {
+      // Abramowitz and Stegun 4.4.49, error 1e-5.
+      float z_sq = z * z;
+      result =
+          z * (0.9998660f +
+               z_sq * (-0.3302995f +
+                       z_sq * (0.1801410f +
+                               z_sq * (-0.0851330f + z_sq * 0.0208351f))));
+    }
+
+    if (abs_y > abs_x) {
+      result = kPi * 0.5f - result;
+    }
+    if (x < 0.0f) {
+      result = kPi - result;
+    }
+    return y < 0.0f ? -result : result;
+  }
+}
+
+/// 1 / sqrtf(v) for v > 0.
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline float Rsqrt(float v) {
+  if constexpr (kAccuracy == Accuracy::kExact) {
+    return 1.0f / sqrtf(v);
+  } else {
+    // Bit level initial guess, relative error 3.4e-2. Every Newton-Raphson
+    // step squares it.
+    float y = std::bit_cast<float>(0x5f375a86u -
+                                   (std::bit_cast<uint32_t>(v) >> 1));
+    y = y * (1.5f - 0.5f * v * y * y);
+    if constexpr (kAccuracy == Accuracy::kHigh) {
+      y = y * (1.5f - 0.5f * v * y * y);
+    }
+    return y;
+  }
+}
+
+/// 1 / v for v != 0.
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline float Rcp(float v) {
+  if constexpr (kAccuracy == Accuracy::kExact) {
+    return 1.0f / v;
+  } else {
+    // Bit level initial guess, relative error 12%.
+    float y = std::bit_cast<float>(0x7ef311c3u - std::bit_cast<uint32_t>(v));
+    y = y * (2.0f - v * y);
+    y = y * (2.0f - v * y);
+    if constexpr (kAccuracy == Accuracy::kHigh) {
+      y = y * (2.0f - v * y);
+    }
+    return y;
+  }
+}
+
+/// Array versions, lane wise with Simd::Float. Input and output can be the
+/// same array.
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline void Sin(const float* angles_rad, int size, float* result_out) {
+  int i = 0;
+  if constexpr (kAccuracy != Accuracy::kExact) {
+    for (; i + Simd::Float::kLanes <= size; i += Simd::Float::kLanes) {
+      SimdFloat x = foldSinArgument(
+          SimdFloat(Simd::Float::Load(angles_rad + i)),
+          [](SimdFloat v) { return SimdFloat(Simd::Round(v)); },
+          [](SimdFloat a, SimdFloat b) { return SimdFloat(Simd::Min(a, b)); },
+          [](SimdFloat a, SimdFloat b) { return SimdFloat(Simd::Max(a, b)); });
+      SimdFloat result = sinPolynomial<kAccuracy>(x);
+      result.Store(result_out + i);
+    }
+    // Same method as the blocks, not the kLow table.
+    for (; i < size; ++i) {
+      result_out[i] = sinFolded<kAccuracy>(angles_rad[i]);
+    }
+  }
+  for (; i < size; ++i) {
+    result_out[i] = Sin<kAccuracy>(angles_rad[i]);
+  }
+}
+
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline void Rsqrt(const float* values, int size, float* result_out) {
+  int i = 0;
+  if constexpr (kAccuracy != Accuracy::kExact) {
+    for (; i + Simd::Float::kLanes <= size; i += Simd::Float::kLanes) {
+      Simd::Float v = Simd::Float::Load(values + i);
+      if constexpr (kAccuracy == Accuracy::kHigh) {
+        Simd::Rsqrt(v).Store(result_out + i);
+      } else {
+        Simd::RsqrtEstimate(v).Store(result_out + i);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    result_out[i] = Rsqrt<kAccuracy>(values[i]);
+  }
+}
+
+template <Accuracy kAccuracy = Accuracy::kHigh>
+inline void Rcp(const float* values, int size, float* result_out) {
+  int i = 0;
+  if constexpr (kAccuracy != Accuracy::kExact) {
+    for (; i + Simd::Float::kLanes <= size; i += Simd::Float::kLanes) {
+      Simd::Float v = Simd::Float::Load(values + i);
+      if constexpr (kAccuracy == Accuracy::kHigh) {
+        Simd::Rcp(v).Store(result_out + i);
+      } else {
+        Simd::RcpEstimate(v).Store(result_out + i);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    result_out[i] = Rcp<kAccuracy>(values[i]);
+  }
+}
+}  // namespace Fast
+}  // namespace Math
+}  // namespace Symphony
@@ -0,0 +1,81 @@
+#include "fast_math.hpp"
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include <vector>
+
+using namespace Symphony::Math;
+using namespace Symphony::Math::Fast;
+
+TEST(FastMath, Trigonometry) {
+  for (float a = -50.0f; a < 50.0f; a += 0.003f) {
+    ASSERT_NEAR(sinf(a), Sin<Accuracy::kExact>(a), 1e-6f);
+    ASSERT_NEAR(sinf(a), Sin<Accuracy::kHigh>(a), 1e-4f);
+    ASSERT_NEAR(cosf(a), Cos<Accuracy::kHigh>(a), 1e-4f);
+    ASSERT_NEAR(sinf(a), Sin<Accuracy::kLow>(a), 1e-2f);
+    ASSERT_NEAR(cosf(a), Cos<Accuracy::kLow>(a), 1e-2f);
+  }
+}
+
+TEST(FastMath, Atan2) {
+  for (float a = -kPi + 0.001f; a < kPi; a += 0.001f) {
+    for (float r : {0.001f, 1.0f, 1000.0f}) {
+      float x = cosf(a) * r;
+      float y = sinf(a) * r;
+      ASSERT_NEAR(atan2f(y, x), Atan2<Accuracy::kHigh>(y, x), 1e-4f);
+      ASSERT_NEAR(atan2f(y, x), Atan2<Accuracy::kLow>(y, x), 1e-2f);
+    }
+  }
+  ASSERT_EQ(0.0f, Atan2(0.0f, 0.0f));
+}
+
+TEST(FastMath, RsqrtRcp) {
+  for (float v = 0.001f; v < 10000.0f; v *= 1.01f) {
+    float rsqrt = 1.0f / sqrtf(v);
+    ASSERT_NEAR(1.0f, Rsqrt<Accuracy::kHigh>(v) / rsqrt, 1e-4f);
+    ASSERT_NEAR(1.0f, Rsqrt<Accuracy::kLow>(v) / rsqrt, 1e-2f);
+
+    ASSERT_NEAR(1.0f, Rcp<Accuracy::kHigh>(v) * v, 1e-4f);
+    ASSERT_NEAR(1.0f, Rcp<Accuracy::kLow>(v) * v, 1e-2f);
+    ASSERT_NEAR(1.0f, Rcp<Accuracy::kHigh>(-v) * -v, 1e-4f);
+  }
+}
+
+TEST(FastMath, Arrays) {
+  // Not a multiple of any SIMD width.
+  std::vector<float> values;
+  for (int i = 0; i < 1003; ++i) {
+    values.push_back((float)i * 0.137f - 60.0f);
+  }
+  std::vector<float> result(values.size());
+
+  Sin<Accuracy::kHigh>(values.data(), (int)values.size(), result.data());
+  for (int i = 0; i < (int)values.size(); ++i) {
+    ASSERT_NEAR(sinf(values[i]), result[i], 1e-4f);
+  }
+  Sin<Accuracy::kLow>(values.data(), (int)values.size(), result.data());
+  for (int i = 0; i < (int)values.size(); ++i) {
+    ASSERT_NEAR(sinf(values[i]), result[i], 1e-2f);
+  }
+
+  // The tail past the last SIMD block uses the same method as the blocks.
+  std::vector<float> same_angle(1003, 1.2345f);
+  Sin<Accuracy::kLow>(same_angle.data(), (int)same_angle.size(),
+                      same_angle.data());
+  for (float v : same_angle) {
+    ASSERT_EQ(same_angle[0], v);
+  }
+
+  for (float& v : values) {
+    v = fabsf(v) + 0.01f;
+  }
+  Rsqrt<Accuracy::kHigh>(values.data(), (int)values.size(), result.data());
+  for (int i = 0; i < (int)values.size(); ++i) {
+    ASSERT_NEAR(1.0f, result[i] * sqrtf(values[i]), 1e-4f);
+  }
+  Rcp<Accuracy::kLow>(values.data(), (int)values.size(), result.data());
+  for (int i = 0; i < (int)values.size(); ++i) {
+    ASSERT_NEAR(1.0f, result[i] * values[i], 1e-2f);
+  }
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <iostream>
+
+namespace Symphony {
+namespace Math {
+// Q16.16 fixed point number for deterministic lockstep simulation and FPU
+// less targets. Results are bit exact on every compiler and platform. Range
+// is about +-32767 with 1/65536 precision, products of two values must stay
+// in range too, or be summed with MulWide.
+class Fixed {
+ public:
+  static constexpr int kFractionBits = 16;
+  static constexpr int32_t kOne = 1 << kFractionBits;
+
+  constexpr Fixed() : raw_(0) {}
+
+  constexpr Fixed(int value) : raw_(value * kOne) {}
+
+  /// Rounds to the nearest representable value. Convert once when loading
+  /// data, not during simulation.
+  constexpr explicit Fixed(float value)
+      : raw_((int32_t)(value * (float)kOne + (value < 0.0f ? -0.5f : 0.5f))) {
+  }
+
+  static constexpr Fixed FromRaw(int32_t raw) {
+    Fixed result;
+    result.raw_ = raw;
+    return result;
+  }
+
+  constexpr int32_t GetRaw() const { return raw_; }
+
+  constexpr float ToFloat() const { return (float)raw_ / (float)kOne; }
+
+  /// Rounds towards negative infinity.
+  constexpr int ToInt() const { return raw_ >> kFractionBits; }
+
+  constexpr Fixed operator-() const { return FromRaw(-raw_); }
+
+  constexpr Fixed operator+(Fixed rhv) const {
+    return FromRaw(raw_ + rhv.raw_);
+  }
+
+  constexpr Fixed operator-(Fixed rhv) const {
+    return FromRaw(raw_ - rhv.raw_);
+  }
+
+  constexpr Fixed operator*(Fixed rhv) const {
+    return FromRaw((int32_t)(((int64_t)raw_ * rhv.raw_) >> kFractionBits));
+  }
+
+  /// Rounds towards zero.
+  constexpr Fixed operator/(Fixed rhv) const {
+    return FromRaw((int32_t)(((int64_t)raw_ * kOne) / rhv.raw_));
+  }
+
+  constexpr Fixed& operator+=(Fixed rhv) { return *this = *this + rhv; }
+  constexpr Fixed& operator-=(Fixed rhv) { return *this = *this - rhv; }
+  constexpr Fixed& operator*=(Fixed rhv) { return *this = *this * rhv; }
+  constexpr Fixed& operator/=(Fixed rhv) { return *this = *this / rhv; }
+
+  constexpr bool operator==(const Fixed& rhv) const = default;
+  constexpr auto operator<=>(const Fixed& rhv) const = default;
+
+  friend std::ostream& operator<<(std::ostream& os, Fixed v) {
+    os << v.ToFloat();
+    return os;
+  }
+
+ private:
+  int32_t raw_;
+};
+
+namespace {
+// Floor of the square root, bit by bit.
+constexpr uint64_t sqrtUInt64(uint64_t v) {
+  uint64_t result = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > v) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (v >= result + bit) {
+      v -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+}  // namespace
+
+// Scalar helpers the math types are written against, so the same code
+// works for float and Fixed.
+
+constexpr float Abs(float v) { return v < 0.0f ? -v : v; }
+
+constexpr Fixed Abs(Fixed v) { return v < Fixed() ? -v : v; }
+
+inline float Sqrt(float v) { return sqrtf(v); }
+
+/// Zero for negative values.
+constexpr Fixed Sqrt(Fixed v) {
+  if (v.GetRaw() <= 0) {
+    return Fixed();
+  }
+  return Fixed::FromRaw(
+      (int32_t)sqrtUInt64((uint64_t)v.GetRaw() << Fixed::kFractionBits));
+}
+
+/// Length of (x, y).
+inline float Hypot(float x, float y) { return sqrtf(x * x + y * y); }
+
+/// Length of (x, y), the sum of squares is kept in 64 bits so it doesn't
+/// overflow for long vectors.
+constexpr Fixed Hypot(Fixed x, Fixed y) {
+  int64_t x_raw = x.GetRaw();
+  int64_t y_raw = y.GetRaw();
+  return Fixed::FromRaw(
+      (int32_t)sqrtUInt64((uint64_t)(x_raw * x_raw + y_raw * y_raw)));
+}
+
+// Products for sums of products that would overflow Fixed, like cross and
+// dot products of world sized vectors: float stays float, Fixed gives the
+// exact Q32.32 raw value.
+
+constexpr float MulWide(float a, float b) { return a * b; }
+
+constexpr int64_t MulWide(Fixed a, Fixed b) {
+  return (int64_t)a.GetRaw() * b.GetRaw();
+}
+
+/// v as a MulWide result, to compare against one.
+constexpr float ToWide(float v) { return v; }
+
+constexpr int64_t ToWide(Fixed v) {
+  return (int64_t)v.GetRaw() << Fixed::kFractionBits;
+}
+
+/// a / b of two MulWide results, 0 <= a <= b.
+constexpr float DivWide(float a, float b) { return a / b; }
+
+/// Rounds towards zero.
+constexpr Fixed DivWide(int64_t a, int64_t b) {
+  // The quotient fits, a * kOne might not: scale both down first.
+  while (b > (INT64_MAX >> Fixed::kFractionBits)) {
+    a >>= 1;
+    b >>= 1;
+  }
+  return Fixed::FromRaw((int32_t)((a << Fixed::kFractionBits) / b));
+}
+
+/// Largest integer not greater than a / b, used to find grid cells.
+constexpr int FloorDiv(Fixed a, Fixed b) {
+  int32_t q = a.GetRaw() / b.GetRaw();
+  int32_t r = a.GetRaw() % b.GetRaw();
+  if (r != 0 && ((r < 0) != (b.GetRaw() < 0))) {
+    --q;
+  }
+  return q;
+}
+}  // namespace Math
+}  // namespace Symphony
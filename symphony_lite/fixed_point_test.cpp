@@ -0,0 +1,125 @@
+#include "fixed_point.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "point2d.hpp"
+#include "segment2d.hpp"
+#include "spatial_bins.hpp"
+#include "vector2d.hpp"
+
+using namespace Symphony::Collision;
+using namespace Symphony::Math;
+
+TEST(Fixed, Arithmetic) {
+  static_assert(Fixed(3) * Fixed(0.5f) == Fixed(1.5f));
+  static_assert((Fixed(-7) / Fixed(2)).GetRaw() == -7 * Fixed::kOne / 2);
+
+  Fixed a(2.25f);
+  Fixed b(-1.5f);
+  ASSERT_EQ(0.75f, (a + b).ToFloat());
+  ASSERT_EQ(3.75f, (a - b).ToFloat());
+  ASSERT_EQ(-3.375f, (a * b).ToFloat());
+  ASSERT_EQ(-1.5f, (a / b).ToFloat());
+  ASSERT_EQ(-2, b.ToInt());
+  ASSERT_TRUE(b < a);
+  ASSERT_EQ(Fixed(1.5f), Abs(b));
+
+  ASSERT_EQ(Fixed(3), Sqrt(Fixed(9)));
+  ASSERT_NEAR(1.41421f, Sqrt(Fixed(2)).ToFloat(), 1.0f / Fixed::kOne);
+  ASSERT_EQ(Fixed(), Sqrt(Fixed(-4)));
+
+  ASSERT_EQ(-2, FloorDiv(Fixed(-3), Fixed(2)));
+  ASSERT_EQ(-1, FloorDiv(Fixed(-2), Fixed(2)));
+  ASSERT_EQ(1, FloorDiv(Fixed(3), Fixed(2)));
+}
+
+TEST(Fixed, Vector) {
+  FixedVector2d v(Fixed(3), Fixed(4));
+  ASSERT_EQ(Fixed(5), v.GetLength());
+  ASSERT_EQ(Fixed(25), v.GetLengthSq());
+
+  // x * x + y * y doesn't fit Q16.16, length still does.
+  FixedVector2d long_v(Fixed(3000), Fixed(4000));
+  ASSERT_EQ(Fixed(5000), long_v.GetLength());
+
+  FixedVector2d n = v.GetNormalized();
+  ASSERT_NEAR(0.6f, n.x.ToFloat(), 2.0f / Fixed::kOne);
+  ASSERT_NEAR(0.8f, n.y.ToFloat(), 2.0f / Fixed::kOne);
+
+  FixedPoint2d p = FixedPoint2d(Fixed(1), Fixed(2)) + v * Fixed(2);
+  ASSERT_EQ(Fixed(7), p.x);
+  ASSERT_EQ(Fixed(10), p.y);
+}
+
+TEST(Fixed, SegmentIntersect) {
+  FixedSegment2d s1(FixedPoint2d(Fixed(0), Fixed(0)),
+                    FixedPoint2d(Fixed(10), Fixed(10)));
+  FixedSegment2d s2(FixedPoint2d(Fixed(0), Fixed(10)),
+                    FixedPoint2d(Fixed(10), Fixed(0)));
+  FixedPoint2d intersection;
+  ASSERT_TRUE(s1.Intersect(s2, Fixed::FromRaw(1), intersection));
+  ASSERT_EQ(Fixed(5), intersection.x);
+  ASSERT_EQ(Fixed(5), intersection.y);
+
+  FixedSegment2d s3(FixedPoint2d(Fixed(20), Fixed(0)),
+                    FixedPoint2d(Fixed(30), Fixed(10)));
+  ASSERT_FALSE(s1.Intersect(s3, Fixed::FromRaw(1), intersection));
+}
+
+TEST(Fixed, LongSegmentIntersect) {
+  // Cross products of these extents are far out of the Fixed range.
+  FixedSegment2d s1(FixedPoint2d(Fixed(-3000), Fixed(-2000)),
+                    FixedPoint2d(Fixed(5000), Fixed(6000)));
+  FixedSegment2d s2(FixedPoint2d(Fixed(-3000), Fixed(6000)),
+                    FixedPoint2d(Fixed(5000), Fixed(-2000)));
+  FixedPoint2d intersection;
+  Fixed s1_fraction;
+  Fixed s2_fraction;
+  ASSERT_TRUE(s1.Intersect(s2, Fixed::FromRaw(1), intersection, s1_fraction,
+                           s2_fraction));
+  ASSERT_EQ(Fixed(1000), intersection.x);
+  ASSERT_EQ(Fixed(2000), intersection.y);
+  ASSERT_EQ(Fixed(0.5f), s1_fraction);
+  ASSERT_EQ(Fixed(0.5f), s2_fraction);
+
+  FixedSegment2d s3(FixedPoint2d(Fixed(400), Fixed(0)),
+                    FixedPoint2d(Fixed(900), Fixed(-700)));
+  ASSERT_FALSE(s1.Intersect(s3, Fixed::FromRaw(1), intersection));
+
+  FixedVector2d v(Fixed(3000), Fixed(4000));
+  ASSERT_EQ(ToWide(Fixed(5000)) * 5000, v.GetLengthSqWide());
+  ASSERT_EQ(ToWide(Fixed(-6000)),
+            v.DotWide(FixedVector2d(Fixed(-2), Fixed(0))));
+}
+
+TEST(Fixed, SpatialBin) {
+  SpatialBin2d<int, Fixed> bins(Fixed(10), Fixed(10), /* num_buckets= */ 64);
+  bins.Add(FixedPoint2d(Fixed(5), Fixed(5)), FixedVector2d(Fixed(1), Fixed(1)),
+           1);
+  bins.Add(FixedPoint2d(Fixed(-25), Fixed(5)),
+           FixedVector2d(Fixed(1), Fixed(1)), 2);
+  bins.Add(FixedPoint2d(), FixedVector2d(Fixed(30), Fixed(30)), 3);
+
+  std::vector<int> result;
+  bins.Query(FixedPoint2d(Fixed(5), Fixed(5)),
+             FixedVector2d(Fixed(2), Fixed(2)), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({1, 3}), result);
+
+  bins.Query(FixedPoint2d(Fixed(-25), Fixed(5)),
+             FixedVector2d(Fixed(2), Fixed(2)), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({2, 3}), result);
+}
+
+// Angle overloads use libm, which isn't bit exact across platforms.
+template <typename Vector>
+concept RotatableByAngle = requires(Vector v) {
+  v.Rotate(0.5f);
+  v.GetRotated(0.5f);
+};
+static_assert(!RotatableByAngle<FixedVector2d>);
+static_assert(RotatableByAngle<Vector2d>);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 namespace Symphony {
 namespace Hash {
@@ -8,9 +9,24 @@ inline uint32_t HashLy(const unsigned char* str, size_t length,
                        uint32_t hash_start = 0) {
   uint32_t result = hash_start;
   for (size_t i = 0; i < length; ++i) {
-    result = (result * 1664525) + (*str) + 1013904223;
+    result = (result * 1664525) + str[i] + 1013904223;
   }
   return result;
 }
+
+// Multiply-xorshift finalizer (splitmix64), every input bit affects every
+// output bit.
+inline uint64_t HashUInt64(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ull;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBull;
+  value ^= value >> 31;
+  return value;
+}
+
+inline uint64_t PackInt2(int i, int j) {
+  return ((uint64_t)(uint32_t)i << 32) | (uint64_t)(uint32_t)j;
+}
 }  // namespace Hash
 }  // namespace Symphony
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "point2d.hpp"
+#include "spatial_bins.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Collision {
+// Stack of SpatialBin2d grids, each level has cells twice as large as the
+// previous one. An object goes to the finest level where it covers at most
+// 2x2 cells, so inserting a huge object costs the same as a small one.
+template <typename ObjectType>
+class HierarchicalSpatialBin2d {
+ public:
+  HierarchicalSpatialBin2d() : HierarchicalSpatialBin2d(1.0f, 1.0f, 8, 1024) {}
+
+  HierarchicalSpatialBin2d(float cell_width, float cell_height, int num_levels,
+                           int num_buckets_per_level) {
+    levels_.reserve(num_levels);
+    for (int i = 0; i < num_levels; ++i) {
+      float scale = (float)(1 << i);
+      levels_.push_back(SpatialBin2d<ObjectType>(
+          cell_width * scale, cell_height * scale, num_buckets_per_level));
+    }
+  }
+
+  void Clear() {
+    for (auto& level : levels_) {
+      level.Clear();
+    }
+  }
+
+  void Add(const Math::Point2d& center, const Math::Vector2d& half_sizes,
+           const ObjectType& object) {
+    levels_[GetLevelIndex(half_sizes)].Add(center, half_sizes, object);
+  }
+
+  void Query(const Math::Point2d& center, const Math::Vector2d& half_sizes,
+             std::vector<ObjectType>& result_out) const {
+    result_out.clear();
+    for (const auto& level : levels_) {
+      level.QueryAppend(center, half_sizes, result_out);
+    }
+  }
+
+  int GetLevelIndex(const Math::Vector2d& half_sizes) const {
+    for (int i = 0; i < (int)levels_.size() - 1; ++i) {
+      if (half_sizes.x * 2.0f <= levels_[i].GetCellWidth() &&
+          half_sizes.y * 2.0f <= levels_[i].GetCellHeight()) {
+        return i;
+      }
+    }
+    return (int)levels_.size() - 1;
+  }
+
+  int GetNumLevels() const { return (int)levels_.size(); }
+
+  const SpatialBin2d<ObjectType>& GetLevel(int level_index) const {
+    return levels_[level_index];
+  }
+
+ private:
+  std::vector<SpatialBin2d<ObjectType>> levels_;
+};
+}  // namespace Collision
+}  // namespace Symphony
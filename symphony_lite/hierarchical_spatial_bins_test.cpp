@@ -0,0 +1,54 @@
+#include "hierarchical_spatial_bins.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace Symphony::Collision;
+using namespace Symphony::Math;
+
+TEST(HierarchicalSpatialBin2d, GetLevelIndex) {
+  HierarchicalSpatialBin2d<int> bins(/* cell_width= */ 1.0f,
+                                     /* cell_height= */ 1.0f,
+                                     /* num_levels= */ 4,
+                                     /* num_buckets_per_level= */ 64);
+  ASSERT_EQ(0, bins.GetLevelIndex(Vector2d(0.25f, 0.5f)));
+  ASSERT_EQ(1, bins.GetLevelIndex(Vector2d(0.25f, 0.75f)));
+  ASSERT_EQ(2, bins.GetLevelIndex(Vector2d(2.0f, 0.5f)));
+  ASSERT_EQ(3, bins.GetLevelIndex(Vector2d(1000.0f, 1000.0f)));
+}
+
+TEST(HierarchicalSpatialBin2d, HugeObjectCoversFewCells) {
+  HierarchicalSpatialBin2d<int> bins(1.0f, 1.0f, /* num_levels= */ 12,
+                                     /* num_buckets_per_level= */ 64);
+  bins.Add(Point2d(0.0f, 0.0f), Vector2d(500.0f, 500.0f), 1);
+
+  int level_index = bins.GetLevelIndex(Vector2d(500.0f, 500.0f));
+  ASSERT_EQ(10, level_index);
+  ASSERT_LE(bins.GetLevel(level_index).GetMaxHashesCollision(), 4);
+}
+
+TEST(HierarchicalSpatialBin2d, QueryWalksAllLevels) {
+  HierarchicalSpatialBin2d<int> bins(1.0f, 1.0f, /* num_levels= */ 8,
+                                     /* num_buckets_per_level= */ 64);
+  bins.Add(Point2d(0.5f, 0.5f), Vector2d(0.1f, 0.1f), 1);
+  bins.Add(Point2d(10.0f, 10.0f), Vector2d(20.0f, 20.0f), 2);
+  bins.Add(Point2d(-5.0f, 3.0f), Vector2d(3.0f, 1.0f), 3);
+  bins.Add(Point2d(200.0f, 200.0f), Vector2d(1.0f, 1.0f), 4);
+
+  std::vector<int> result;
+  bins.Query(Point2d(0.5f, 0.5f), Vector2d(0.2f, 0.2f), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({1, 2}), result);
+
+  bins.Query(Point2d(-5.0f, 3.0f), Vector2d(0.2f, 0.2f), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({2, 3}), result);
+
+  bins.Query(Point2d(200.0f, 200.0f), Vector2d(0.2f, 0.2f), result);
+  ASSERT_EQ(std::vector<int>({4}), result);
+
+  bins.Clear();
+  bins.Query(Point2d(0.5f, 0.5f), Vector2d(100.0f, 100.0f), result);
+  ASSERT_TRUE(result.empty());
+}
@@ -1,10 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <stack>
 #include <tuple>
-#include <unordered_map>
+#include <vector>
 
 #include "font.hpp"
 #include "formatted_text.hpp"
@@ -36,6 +37,8 @@ struct MeasuredGlyph {
 
 // See: https://www.angelcode.com/products/bmfont/doc/render_text.html.
 struct MeasuredTextLine {
+  int GetNumGlyphs() const { return glyph_end - glyph_begin; }
+
   HorizontalAlignment align{HorizontalAlignment::kLeft};
   Wrapping wrapping{Wrapping::kClip};
   int line_x_advance{0};
@@ -43,194 +46,387 @@ struct MeasuredTextLine {
   int line_height{0};
   int base{0};
   int align_offset{0};
-  std::list<MeasuredGlyph> glyphs;
-  std::unordered_map<Font*, std::list<MeasuredGlyph*>> font_to_glyph;
+  /// Range of MeasuredText::glyphs.
+  int glyph_begin{0};
+  int glyph_end{0};
+  /// Range of MeasuredText::font_runs.
+  int font_run_begin{0};
+  int font_run_end{0};
 };
 
-namespace {
-MeasuredGlyph* addGlyph(MeasuredTextLine& measured_line, const Glyph& glyph) {
-  measured_line.glyphs.push_back(MeasuredGlyph());
-  auto* cur_measured_glyph_ptr = &measured_line.glyphs.back();
+// Glyphs of one line drawn with one font.
+struct FontRun {
+  Font* font{nullptr};
+  /// Range of MeasuredText::font_glyph_indices.
+  int begin{0};
+  int end{0};
+};
 
-  if (measured_line.glyphs.size() == 1) {
+// All lines share flat arrays, so measuring allocates per text and not per
+// glyph.
+struct MeasuredText {
+  std::vector<MeasuredTextLine> measured_lines;
+  std::vector<MeasuredGlyph> glyphs;
+  std::vector<FontRun> font_runs;
+  /// Indices into glyphs. Over the range of a line they are the glyphs of
+  /// that line grouped by font, in line order within a font.
+  std::vector<int> font_glyph_indices;
+  /// Number of measured_lines of every paragraph.
+  std::vector<int> paragraph_line_counts;
+  std::map<std::string, std::shared_ptr<Font>> fonts;
+};
+
+namespace {
+// Appends to the last line of measured_text.
+MeasuredGlyph& addGlyph(MeasuredText& measured_text, const Glyph& glyph) {
+  auto& measured_line = measured_text.measured_lines.back();
+  measured_text.glyphs.push_back(MeasuredGlyph());
+  auto& cur_measured_glyph = measured_text.glyphs.back();
+  measured_line.glyph_end = (int)measured_text.glyphs.size();
+
+  if (measured_line.GetNumGlyphs() == 1) {
     measured_line.line_x_advance = -glyph.x_offset;
   }
 
-  cur_measured_glyph_ptr->glyph = glyph;
+  cur_measured_glyph.glyph = glyph;
 
-  cur_measured_glyph_ptr->line_x_advance_before_this_glyph =
+  cur_measured_glyph.line_x_advance_before_this_glyph =
       measured_line.line_x_advance;
-  cur_measured_glyph_ptr->line_width_before_this_glyph =
-      measured_line.line_width;
+  cur_measured_glyph.line_width_before_this_glyph = measured_line.line_width;
   measured_line.line_width = measured_line.line_x_advance +
-                             cur_measured_glyph_ptr->glyph.x_offset +
-                             cur_measured_glyph_ptr->glyph.texture_width;
-  measured_line.line_x_advance += cur_measured_glyph_ptr->glyph.x_advance;
+                             cur_measured_glyph.glyph.x_offset +
+                             cur_measured_glyph.glyph.texture_width;
+  measured_line.line_x_advance += cur_measured_glyph.glyph.x_advance;
 
-  return cur_measured_glyph_ptr;
+  return cur_measured_glyph;
 }
-}  // namespace
 
-struct MeasuredText {
-  std::list<MeasuredTextLine> measured_lines;
-  std::map<std::string, std::shared_ptr<Font>> fonts;
-};
-
-std::optional<MeasuredText> MeasureText(
-    int container_width, const FormattedText& formatted_text,
-    const std::map<std::string, std::string>& variables,
-    const std::map<std::string, std::shared_ptr<Font>>& fonts) {
-  (void)variables;
-
-  MeasuredText result;
-  result.fonts = fonts;
+void addLine(MeasuredText& measured_text) {
+  MeasuredTextLine measured_line;
+  measured_line.glyph_begin = (int)measured_text.glyphs.size();
+  measured_line.glyph_end = measured_line.glyph_begin;
+  measured_text.measured_lines.push_back(measured_line);
+}
 
-  if (formatted_text.paragraphs.empty()) {
-    return result;
+// Lays out one paragraph, its lines and glyphs are appended to
+// measured_text. They are finished by finishLine.
+bool measureParagraph(
+    int container_width, const Paragraph& paragraph, size_t paragraph_index,
+    const std::map<std::string, std::shared_ptr<Font>>& fonts,
+    MeasuredText& measured_text) {
+  auto& lines = measured_text.measured_lines;
+  auto& glyphs = measured_text.glyphs;
+
+  addLine(measured_text);
+  lines.back().align = paragraph.paragraph_parameters.align;
+  lines.back().wrapping = paragraph.paragraph_parameters.wrapping;
+
+  auto paragraph_font_it = fonts.find(paragraph.font);
+  if (paragraph_font_it != fonts.end()) {
+    auto font_measurements = paragraph_font_it->second->GetFontMeasurements();
+    lines.back().line_height = font_measurements.line_height;
   }
 
-  for (size_t paragraph_index = 0;
-       const auto& paragraph : formatted_text.paragraphs) {
-    result.measured_lines.push_back(MeasuredTextLine());
-    auto* cur_measured_line_ptr = &result.measured_lines.back();
-
-    cur_measured_line_ptr->align = paragraph.paragraph_parameters.align;
-    cur_measured_line_ptr->wrapping = paragraph.paragraph_parameters.wrapping;
-
-    auto paragraph_font_it = fonts.find(paragraph.font);
-    if (paragraph_font_it != fonts.end()) {
-      auto font_measurements = paragraph_font_it->second->GetFontMeasurements();
-      result.measured_lines.back().line_height = font_measurements.line_height;
+  bool has_prev_not_whitespace = false;
+  // Index in glyphs, -1 when the line has none.
+  int line_prev_whitespace = -1;
+  // Glyphs moved to the next line by word wrapping.
+  std::vector<MeasuredGlyph> moved_glyphs;
+
+  for (const auto& style_run : paragraph.style_runs) {
+    auto style_font_it = fonts.find(style_run.style.font);
+    if (style_font_it == fonts.end()) {
+      LOGE("[Symphony::Text::MeasuredText] Unknown font, paragraph: {}",
+           paragraph_index);
+      return false;
     }
 
-    bool has_prev_not_whitespace = false;
-    auto line_prev_whitespace_it = cur_measured_line_ptr->glyphs.end();
+    uint32_t color = style_run.style.color;
 
-    for (const auto& style_run : paragraph.style_runs) {
-      auto style_font_it = fonts.find(style_run.style.font);
-      if (style_font_it == fonts.end()) {
-        LOGE("[Symphony::Text::MeasuredText] Unknown font, paragraph: {}",
-             paragraph_index);
-        return std::nullopt;
+    const char* text = style_run.text.data();
+    size_t text_length = style_run.text.size();
+
+    while (text_length) {
+      auto utf_result = ParseUtf8Sequence<false>(text, text_length);
+      if (!utf_result.code_position.has_value()) {
+        LOGE(
+            "[Symphony::Text::MeasuredText] Not a valid UTF-8 text, "
+            "paragraph: {}",
+            paragraph_index);
+        return false;
       }
 
-      uint32_t color = style_run.style.color;
+      text += utf_result.parsed_sequence_length;
+      text_length -= utf_result.parsed_sequence_length;
 
-      const char* text = style_run.text.data();
-      size_t text_length = style_run.text.size();
+      auto& cur_measured_glyph = addGlyph(
+          measured_text,
+          style_font_it->second->GetGlyph(utf_result.code_position.value()));
+      cur_measured_glyph.color = color;
+      cur_measured_glyph.from_font = style_font_it->second.get();
 
-      while (text_length) {
-        auto utf_result = ParseUtf8Sequence<false>(text, text_length);
-        if (!utf_result.code_position.has_value()) {
-          LOGE(
-              "[Symphony::Text::MeasuredText] Not a valid UTF-8 text, "
-              "paragraph: {}",
-              paragraph_index);
-          return std::nullopt;
-        }
+      if (paragraph.paragraph_parameters.wrapping == Wrapping::kWordWrap) {
+        if (IsWhitespace(cur_measured_glyph.glyph.code_position)) {
+          if (has_prev_not_whitespace) {
+            has_prev_not_whitespace = false;
 
-        text += utf_result.parsed_sequence_length;
-        text_length -= utf_result.parsed_sequence_length;
+            line_prev_whitespace = (int)glyphs.size() - 1;
+          }
+        } else {
+          has_prev_not_whitespace = true;
+          if (lines.back().line_width > container_width) {
+            if (line_prev_whitespace >= 0) {
+              // Reduce current line width:
+              lines.back().line_width =
+                  glyphs[line_prev_whitespace].line_width_before_this_glyph;
+
+              // Find first not whitespace glyph:
+              int not_whitespace = line_prev_whitespace;
+              while (not_whitespace < (int)glyphs.size() &&
+                     IsWhitespace(glyphs[not_whitespace].glyph.code_position)) {
+                ++not_whitespace;
+              }
 
-        auto* cur_measured_glyph_ptr = addGlyph(
-            *cur_measured_line_ptr,
-            style_font_it->second->GetGlyph(utf_result.code_position.value()));
-        cur_measured_glyph_ptr->color = color;
-        cur_measured_glyph_ptr->from_font = style_font_it->second.get();
+              moved_glyphs.assign(glyphs.begin() + not_whitespace,
+                                  glyphs.end());
+              glyphs.resize(line_prev_whitespace);
+              lines.back().glyph_end = line_prev_whitespace;
 
-        if (paragraph.paragraph_parameters.wrapping == Wrapping::kWordWrap) {
-          if (IsWhitespace(cur_measured_glyph_ptr->glyph.code_position)) {
-            if (has_prev_not_whitespace) {
-              has_prev_not_whitespace = false;
+              // New line:
+              addLine(measured_text);
+              lines.back().align = paragraph.paragraph_parameters.align;
 
-              line_prev_whitespace_it = cur_measured_line_ptr->glyphs.end();
-              --line_prev_whitespace_it;
-            }
-          } else {
-            has_prev_not_whitespace = true;
-            if (cur_measured_line_ptr->line_width > container_width) {
-              if (line_prev_whitespace_it !=
-                  cur_measured_line_ptr->glyphs.end()) {
-                // Reduce current line width:
-                cur_measured_line_ptr->line_width =
-                    line_prev_whitespace_it->line_width_before_this_glyph;
-
-                result.measured_lines.push_back(MeasuredTextLine());
-
-                auto* next_measured_line_ptr = &result.measured_lines.back();
-                next_measured_line_ptr->align =
-                    paragraph.paragraph_parameters.align;
-
-                // Find first not whitespace glyph:
-                auto not_whitespace_it = line_prev_whitespace_it;
-                while (not_whitespace_it !=
-                           cur_measured_line_ptr->glyphs.end() &&
-                       IsWhitespace(not_whitespace_it->glyph.code_position)) {
-                  ++not_whitespace_it;
-                }
-
-                if (not_whitespace_it != cur_measured_line_ptr->glyphs.end()) {
-                  for (auto it = not_whitespace_it;
-                       it != cur_measured_line_ptr->glyphs.end(); ++it) {
-                    auto* next_line_measured_glyph_ptr =
-                        addGlyph(*next_measured_line_ptr, it->glyph);
-                    next_line_measured_glyph_ptr->color = it->color;
-                    next_line_measured_glyph_ptr->from_font = it->from_font;
-                  }
-                }
-
-                cur_measured_line_ptr->glyphs.erase(
-                    line_prev_whitespace_it,
-                    cur_measured_line_ptr->glyphs.end());
-
-                // New line:
-                cur_measured_line_ptr = next_measured_line_ptr;
-
-                has_prev_not_whitespace = false;
-                line_prev_whitespace_it = next_measured_line_ptr->glyphs.end();
+              for (const auto& moved_glyph : moved_glyphs) {
+                auto& next_line_measured_glyph =
+                    addGlyph(measured_text, moved_glyph.glyph);
+                next_line_measured_glyph.color = moved_glyph.color;
+                next_line_measured_glyph.from_font = moved_glyph.from_font;
               }
+
+              has_prev_not_whitespace = false;
+              line_prev_whitespace = -1;
             }
           }
         }
       }
     }
+  }
 
-    ++paragraph_index;
+  return true;
+}
+
+// Alignment, line height, glyph positions and font runs once the glyphs of
+// the line are known. Lines are finished in order.
+void finishLine(int container_width, MeasuredText& measured_text,
+                MeasuredTextLine& measured_line) {
+  if (measured_line.align == HorizontalAlignment::kLeft) {
+    measured_line.align_offset = 0;
+  } else if (measured_line.align == HorizontalAlignment::kCenter) {
+    measured_line.align_offset =
+        (container_width - measured_line.line_width) / 2;
+  } else if (measured_line.align == HorizontalAlignment::kRight) {
+    measured_line.align_offset = container_width - measured_line.line_width;
   }
 
-  for (auto& measured_line : result.measured_lines) {
-    if (measured_line.align == HorizontalAlignment::kLeft) {
-      measured_line.align_offset = 0;
-    } else if (measured_line.align == HorizontalAlignment::kCenter) {
-      measured_line.align_offset =
-          (container_width - measured_line.line_width) / 2;
-    } else if (measured_line.align == HorizontalAlignment::kRight) {
-      measured_line.align_offset = container_width - measured_line.line_width;
-    }
+  auto& glyphs = measured_text.glyphs;
+  for (int i = measured_line.glyph_begin; i < measured_line.glyph_end; ++i) {
+    auto& measured_glyph = glyphs[i];
+    auto font_measurements = measured_glyph.from_font->GetFontMeasurements();
+    measured_line.line_height =
+        std::max(measured_line.line_height, font_measurements.line_height);
+    measured_line.base = std::max(measured_line.base, font_measurements.base);
+    measured_glyph.base = font_measurements.base;
+  }
+
+  int base = measured_line.base;
+  for (int i = measured_line.glyph_begin; i < measured_line.glyph_end; ++i) {
+    auto& measured_glyph = glyphs[i];
+    measured_glyph.x = measured_glyph.line_x_advance_before_this_glyph +
+                       measured_glyph.glyph.x_offset;
 
-    for (auto& measured_glyph : measured_line.glyphs) {
-      auto font_measurements = measured_glyph.from_font->GetFontMeasurements();
-      measured_line.line_height =
-          std::max(measured_line.line_height, font_measurements.line_height);
-      measured_line.base = std::max(measured_line.base, font_measurements.base);
-      measured_glyph.base = font_measurements.base;
+    int above_base_height =
+        measured_glyph.base - measured_glyph.glyph.y_offset;
+    measured_glyph.y = base - above_base_height;
+  }
+
+  // Counting sort of the glyph indices by font, a line has few fonts.
+  auto& font_runs = measured_text.font_runs;
+  auto find_run = [&](Font* font) -> FontRun& {
+    for (int r = measured_line.font_run_begin; r < (int)font_runs.size();
+         ++r) {
+      if (font_runs[r].font == font) {
+        return font_runs[r];
+      }
     }
+    font_runs.push_back(FontRun{font, 0, 0});
+    return font_runs.back();
+  };
 
-    int base = measured_line.base;
-    for (auto& measured_glyph : measured_line.glyphs) {
-      measured_glyph.x = measured_glyph.line_x_advance_before_this_glyph +
-                         measured_glyph.glyph.x_offset;
+  measured_line.font_run_begin = (int)font_runs.size();
+  for (int i = measured_line.glyph_begin; i < measured_line.glyph_end; ++i) {
+    ++find_run(glyphs[i].from_font).end;
+  }
+  measured_line.font_run_end = (int)font_runs.size();
+
+  int offset = measured_line.glyph_begin;
+  for (int r = measured_line.font_run_begin; r < measured_line.font_run_end;
+       ++r) {
+    font_runs[r].begin = offset;
+    offset += font_runs[r].end;
+    // Insertion cursor until the indices are placed.
+    font_runs[r].end = font_runs[r].begin;
+  }
 
-      int above_base_height =
-          measured_glyph.base - measured_glyph.glyph.y_offset;
-      measured_glyph.y = base - above_base_height;
+  auto& font_glyph_indices = measured_text.font_glyph_indices;
+  font_glyph_indices.resize(measured_line.glyph_end);
+  for (int i = measured_line.glyph_begin; i < measured_line.glyph_end; ++i) {
+    font_glyph_indices[find_run(glyphs[i].from_font).end++] = i;
+  }
+}
 
-      measured_line.font_to_glyph[measured_glyph.from_font].push_back(
-          &measured_glyph);
+// Measures paragraphs [paragraph_begin, paragraph_end) into measured_text,
+// after its lines.
+bool measureParagraphs(
+    int container_width, const FormattedText& formatted_text,
+    size_t paragraph_begin, size_t paragraph_end,
+    const std::map<std::string, std::shared_ptr<Font>>& fonts,
+    MeasuredText& measured_text) {
+  auto& lines = measured_text.measured_lines;
+  size_t first_line = lines.size();
+  for (size_t paragraph_index = paragraph_begin;
+       paragraph_index < paragraph_end; ++paragraph_index) {
+    size_t num_lines_before = lines.size();
+    if (!measureParagraph(container_width,
+                          formatted_text.paragraphs[paragraph_index],
+                          paragraph_index, fonts, measured_text)) {
+      return false;
     }
+    measured_text.paragraph_line_counts.push_back(
+        (int)(lines.size() - num_lines_before));
+  }
+
+  for (size_t i = first_line; i < lines.size(); ++i) {
+    finishLine(container_width, measured_text, lines[i]);
+  }
+
+  return true;
+}
+
+// Moves the ranges of lines from line_begin, of font runs from run_begin and
+// the glyph indices from glyph_begin, by the given number of elements.
+void shiftRanges(MeasuredText& measured_text, size_t line_begin,
+                 size_t run_begin, size_t glyph_begin, int glyph_shift,
+                 int run_shift) {
+  auto& lines = measured_text.measured_lines;
+  for (size_t i = line_begin; i < lines.size(); ++i) {
+    lines[i].glyph_begin += glyph_shift;
+    lines[i].glyph_end += glyph_shift;
+    lines[i].font_run_begin += run_shift;
+    lines[i].font_run_end += run_shift;
+  }
+  auto& font_runs = measured_text.font_runs;
+  for (size_t i = run_begin; i < font_runs.size(); ++i) {
+    font_runs[i].begin += glyph_shift;
+    font_runs[i].end += glyph_shift;
+  }
+  auto& font_glyph_indices = measured_text.font_glyph_indices;
+  for (size_t i = glyph_begin; i < font_glyph_indices.size(); ++i) {
+    font_glyph_indices[i] += glyph_shift;
+  }
+}
+
+template <typename T>
+void replaceRange(std::vector<T>& values, int begin, int end,
+                  const std::vector<T>& new_values) {
+  values.erase(values.begin() + begin, values.begin() + end);
+  values.insert(values.begin() + begin, new_values.begin(), new_values.end());
+}
+}  // namespace
+
+std::optional<MeasuredText> MeasureText(
+    int container_width, const FormattedText& formatted_text,
+    const std::map<std::string, std::string>& variables,
+    const std::map<std::string, std::shared_ptr<Font>>& fonts) {
+  (void)variables;
+
+  MeasuredText result;
+  result.fonts = fonts;
+
+  if (!measureParagraphs(container_width, formatted_text, 0,
+                         formatted_text.paragraphs.size(), fonts, result)) {
+    return std::nullopt;
   }
 
   return result;
 }
+
+/// Incremental MeasureText for edited text: the paragraphs of new_text
+/// replace num_old_paragraphs measured ones starting at paragraph_begin.
+/// Only they are measured, lines of the other paragraphs are kept.
+/// Appending is paragraph_begin equal to the old paragraph count and
+/// num_old_paragraphs zero.
+/// Returns the index of the first changed line, or std::nullopt and leaves
+/// measured_text as it was on errors and out of range paragraphs.
+std::optional<int> ReMeasureText(int container_width,
+                                 const FormattedText& new_text,
+                                 int paragraph_begin, int num_old_paragraphs,
+                                 MeasuredText& measured_text) {
+  if (paragraph_begin < 0 || num_old_paragraphs < 0 ||
+      paragraph_begin + num_old_paragraphs >
+          (int)measured_text.paragraph_line_counts.size()) {
+    LOGE("[Symphony::Text::MeasuredText] Paragraphs out of range: {}, {}",
+         paragraph_begin, num_old_paragraphs);
+    return std::nullopt;
+  }
+
+  MeasuredText added;
+  if (!measureParagraphs(container_width, new_text, 0,
+                         new_text.paragraphs.size(), measured_text.fonts,
+                         added)) {
+    return std::nullopt;
+  }
+
+  auto& line_counts = measured_text.paragraph_line_counts;
+  int first_line = 0;
+  for (int i = 0; i < paragraph_begin; ++i) {
+    first_line += line_counts[i];
+  }
+  int end_line = first_line;
+  for (int i = paragraph_begin; i < paragraph_begin + num_old_paragraphs;
+       ++i) {
+    end_line += line_counts[i];
+  }
+
+  // Glyphs and font runs of the replaced lines.
+  auto& lines = measured_text.measured_lines;
+  int glyph_begin = (int)measured_text.glyphs.size();
+  int run_begin = (int)measured_text.font_runs.size();
+  if (first_line < (int)lines.size()) {
+    glyph_begin = lines[first_line].glyph_begin;
+    run_begin = lines[first_line].font_run_begin;
+  }
+  int glyph_end = (int)measured_text.glyphs.size();
+  int run_end = (int)measured_text.font_runs.size();
+  if (end_line < (int)lines.size()) {
+    glyph_end = lines[end_line].glyph_begin;
+    run_end = lines[end_line].font_run_begin;
+  }
+
+  shiftRanges(measured_text, end_line, run_end, glyph_end,
+              (int)added.glyphs.size() - (glyph_end - glyph_begin),
+              (int)added.font_runs.size() - (run_end - run_begin));
+  shiftRanges(added, 0, 0, 0, glyph_begin, run_begin);
+
+  replaceRange(lines, first_line, end_line, added.measured_lines);
+  replaceRange(measured_text.glyphs, glyph_begin, glyph_end, added.glyphs);
+  replaceRange(measured_text.font_runs, run_begin, run_end, added.font_runs);
+  replaceRange(measured_text.font_glyph_indices, glyph_begin, glyph_end,
+               added.font_glyph_indices);
+  replaceRange(line_counts, paragraph_begin,
+               paragraph_begin + num_old_paragraphs,
+               added.paragraph_line_counts);
+
+  return first_line;
+}
 }  // namespace Text
 }  // namespace Symphony
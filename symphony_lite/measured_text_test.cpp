@@ -41,12 +41,20 @@ class MonoFont : public Font {
   int width_{0};
 };
 
-std::string ToStringWhenAscii(const std::list<MeasuredGlyph*>& glyphs) {
+// Glyphs of the line drawn with the font.
+std::string ToStringWhenAscii(const MeasuredText& measured_text,
+                              const MeasuredTextLine& line, Font* font) {
   std::string result;
-  result.reserve(glyphs.size());
-
-  for (const auto* glyph : glyphs) {
-    result.push_back(static_cast<char>(glyph->glyph.code_position));
+  for (int r = line.font_run_begin; r < line.font_run_end; ++r) {
+    const auto& font_run = measured_text.font_runs[r];
+    if (font_run.font != font) {
+      continue;
+    }
+    for (int i = font_run.begin; i < font_run.end; ++i) {
+      const auto& measured_glyph =
+          measured_text.glyphs[measured_text.font_glyph_indices[i]];
+      result.push_back(static_cast<char>(measured_glyph.glyph.code_position));
+    }
   }
 
   return result;
@@ -69,16 +77,15 @@ TEST(MeasuredText, NoWrappingProducesSingleLine) {
 
   ASSERT_TRUE(result.has_value());
 
-  EXPECT_THAT(result->measured_lines,
-              ElementsAreArray({Field(&MeasuredTextLine::glyphs, SizeIs(44))}));
-
-  const auto& mono_24_glyphs =
-      result->measured_lines.front().font_to_glyph[mono_24.get()];
-  ASSERT_EQ(ToStringWhenAscii(mono_24_glyphs), "One two three four five ");
+  EXPECT_THAT(
+      result->measured_lines,
+      ElementsAreArray({Property(&MeasuredTextLine::GetNumGlyphs, 44)}));
 
-  const auto& mono_32_glyphs =
-      result->measured_lines.front().font_to_glyph[mono_32.get()];
-  ASSERT_EQ(ToStringWhenAscii(mono_32_glyphs), "six seven eight nine");
+  const auto& line = result->measured_lines.front();
+  ASSERT_EQ(ToStringWhenAscii(result.value(), line, mono_24.get()),
+            "One two three four five ");
+  ASSERT_EQ(ToStringWhenAscii(result.value(), line, mono_32.get()),
+            "six seven eight nine");
 }
 
 TEST(MeasuredText, SingleParagraphManyLines) {
@@ -100,10 +107,87 @@ TEST(MeasuredText, SingleParagraphManyLines) {
   ASSERT_TRUE(result.has_value());
   EXPECT_THAT(result->measured_lines,
               ElementsAreArray({
-                  Field(&MeasuredTextLine::glyphs, SizeIs(7)),
-                  Field(&MeasuredTextLine::glyphs, SizeIs(10)),
-                  Field(&MeasuredTextLine::glyphs, SizeIs(8)),
-                  Field(&MeasuredTextLine::glyphs, SizeIs(5)),
-                  Field(&MeasuredTextLine::glyphs, SizeIs(10)),
+                  Property(&MeasuredTextLine::GetNumGlyphs, 7),
+                  Property(&MeasuredTextLine::GetNumGlyphs, 10),
+                  Property(&MeasuredTextLine::GetNumGlyphs, 8),
+                  Property(&MeasuredTextLine::GetNumGlyphs, 5),
+                  Property(&MeasuredTextLine::GetNumGlyphs, 10),
               }));
 }
+
+TEST(MeasuredText, ReMeasureMatchesFullMeasure) {
+  ParagraphParameters word_wrap(HorizontalAlignment::kLeft,
+                                Wrapping::kWordWrap);
+  auto old_text = FormatText("One two\nthree four five six seven\nEight",
+                             Style("mono_24", 0xFFFF0000), word_wrap, {});
+  auto new_text = FormatText(
+      "One two\nnine\nten eleven twelve thirteen\nEight\nfourteen",
+      Style("mono_24", 0xFFFF0000), word_wrap, {});
+  auto edited_text = FormatText("nine\nten eleven twelve thirteen",
+                                Style("mono_24", 0xFFFF0000), word_wrap, {});
+  auto appended_text =
+      FormatText("fourteen", Style("mono_24", 0xFFFF0000), word_wrap, {});
+
+  std::shared_ptr<Font> mono_24 = std::make_shared<MonoFont>(
+      /*new_line_height*/ 46, /*new_base*/ 40, /*width*/ 24);
+  auto measured = MeasureText(/*container_width*/ 240, old_text.value(),
+                              /*variables*/ {}, {{"mono_24", mono_24}});
+  ASSERT_TRUE(measured.has_value());
+  EXPECT_THAT(measured->paragraph_line_counts, ElementsAre(1, 3, 1));
+
+  // Second paragraph edited into two.
+  auto first_changed_line = ReMeasureText(
+      /*container_width*/ 240, edited_text.value(), /*paragraph_begin*/ 1,
+      /*num_old_paragraphs*/ 1, measured.value());
+  ASSERT_EQ(1, first_changed_line);
+  // Appended.
+  first_changed_line = ReMeasureText(
+      /*container_width*/ 240, appended_text.value(), /*paragraph_begin*/ 4,
+      /*num_old_paragraphs*/ 0, measured.value());
+  ASSERT_EQ(6, first_changed_line);
+
+  auto expected = MeasureText(/*container_width*/ 240, new_text.value(),
+                              /*variables*/ {}, {{"mono_24", mono_24}});
+  ASSERT_TRUE(expected.has_value());
+  EXPECT_EQ(expected->paragraph_line_counts, measured->paragraph_line_counts);
+  ASSERT_EQ(expected->measured_lines.size(), measured->measured_lines.size());
+  for (size_t i = 0; i < expected->measured_lines.size(); ++i) {
+    const auto& expected_line = expected->measured_lines[i];
+    const auto& line = measured->measured_lines[i];
+    EXPECT_EQ(expected_line.line_width, line.line_width);
+    EXPECT_EQ(expected_line.glyph_begin, line.glyph_begin);
+    EXPECT_EQ(expected_line.font_run_begin, line.font_run_begin);
+    EXPECT_EQ(ToStringWhenAscii(expected.value(), expected_line, mono_24.get()),
+              ToStringWhenAscii(measured.value(), line, mono_24.get()));
+  }
+  EXPECT_EQ(expected->font_glyph_indices, measured->font_glyph_indices);
+}
+
+TEST(MeasuredText, ReMeasureOutOfRange) {
+  ParagraphParameters word_wrap(HorizontalAlignment::kLeft,
+                                Wrapping::kWordWrap);
+  auto text = FormatText("One two\nthree", Style("mono_24", 0xFFFF0000),
+                         word_wrap, {});
+  std::shared_ptr<Font> mono_24 = std::make_shared<MonoFont>(
+      /*new_line_height*/ 46, /*new_base*/ 40, /*width*/ 24);
+  auto measured = MeasureText(/*container_width*/ 240, text.value(),
+                              /*variables*/ {}, {{"mono_24", mono_24}});
+  ASSERT_TRUE(measured.has_value());
+
+  EXPECT_FALSE(ReMeasureText(/*container_width*/ 240, text.value(),
+                             /*paragraph_begin*/ 3, /*num_old_paragraphs*/ 0,
+                             measured.value()));
+  EXPECT_FALSE(ReMeasureText(/*container_width*/ 240, text.value(),
+                             /*paragraph_begin*/ 1, /*num_old_paragraphs*/ 2,
+                             measured.value()));
+  EXPECT_FALSE(ReMeasureText(/*container_width*/ 240, text.value(),
+                             /*paragraph_begin*/ -1, /*num_old_paragraphs*/ 1,
+                             measured.value()));
+  EXPECT_THAT(measured->paragraph_line_counts, ElementsAre(1, 1));
+  EXPECT_EQ(2, (int)measured->measured_lines.size());
+
+  // Appending at the end is in range.
+  EXPECT_EQ(2, ReMeasureText(/*container_width*/ 240, text.value(),
+                             /*paragraph_begin*/ 2, /*num_old_paragraphs*/ 0,
+                             measured.value()));
+}
@@ -4,33 +4,38 @@
 
 namespace Symphony {
 namespace Math {
-class Point2d {
+/// \arg Scalar float or Fixed.
+template <typename Scalar>
+class BasicPoint2d {
  public:
-  Point2d() : x(0.0f), y(0.0f) {}
+  constexpr BasicPoint2d() : x(0), y(0) {}
 
-  Point2d(float new_x, float new_y) : x(new_x), y(new_y) {}
+  constexpr BasicPoint2d(Scalar new_x, Scalar new_y) : x(new_x), y(new_y) {}
 
-  Vector2d operator-(const Point2d& p) const {
-    return Vector2d(x - p.x, y - p.y);
+  constexpr BasicVector2d<Scalar> operator-(const BasicPoint2d& p) const {
+    return BasicVector2d<Scalar>(x - p.x, y - p.y);
   }
 
-  Point2d operator-(const Vector2d& v) const {
-    return Point2d(x - v.x, y - v.y);
+  constexpr BasicPoint2d operator-(const BasicVector2d<Scalar>& v) const {
+    return BasicPoint2d(x - v.x, y - v.y);
   }
 
-  Point2d operator+(const Vector2d& v) const {
-    return Point2d(x + v.x, y + v.y);
+  constexpr BasicPoint2d operator+(const BasicVector2d<Scalar>& v) const {
+    return BasicPoint2d(x + v.x, y + v.y);
   }
 
-  friend std::ostream& operator<<(std::ostream& os, const Point2d& p) {
+  friend std::ostream& operator<<(std::ostream& os, const BasicPoint2d& p) {
     os << "Point2d(x: " << p.x << ", y: " << p.y << ")";
     return os;
   }
 
-  float x;
-  float y;
+  Scalar x;
+  Scalar y;
 };
 
+using Point2d = BasicPoint2d<float>;
+using FixedPoint2d = BasicPoint2d<Fixed>;
+
 inline bool AreOnLine(const Point2d& p1, const Point2d& p2, const Point2d& p3,
                       float eps) {
   if (fabs(p2.x - p1.x) > fabs(p2.y - p1.y)) {
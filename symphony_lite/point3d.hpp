@@ -6,20 +6,20 @@ namespace Symphony {
 namespace Math {
 class Point3d {
  public:
-  Point3d() : x(0.0f), y(0.0f), z(0.0f) {}
+  constexpr Point3d() : x(0.0f), y(0.0f), z(0.0f) {}
 
-  Point3d(float new_x, float new_y, float new_z)
+  constexpr Point3d(float new_x, float new_y, float new_z)
       : x(new_x), y(new_y), z(new_z) {}
 
-  Vector3d operator-(const Point3d& p) const {
+  constexpr Vector3d operator-(const Point3d& p) const {
     return Vector3d(x - p.x, y - p.y, z - p.z);
   }
 
-  Point3d operator-(const Vector3d& v) const {
+  constexpr Point3d operator-(const Vector3d& v) const {
     return Point3d(x - v.x, y - v.y, z - v.z);
   }
 
-  Point3d operator+(const Vector3d& v) const {
+  constexpr Point3d operator+(const Vector3d& v) const {
     return Point3d(x + v.x, y + v.y, z + v.z);
   }
 
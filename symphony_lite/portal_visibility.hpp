@@ -0,0 +1,363 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "point2d.hpp"
+#include "ray_casting_projection.hpp"
+#include "segment2d.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Visibility {
+// Rectangle of tiles [i_begin, i_end) x [j_begin, j_end), usually a room.
+struct Sector {
+  Math::Point2d GetCenter() const {
+    return Math::Point2d((float)(i_begin + i_end) * 0.5f,
+                         (float)(j_begin + j_end) * 0.5f);
+  }
+
+  /// With GetCenter, the rect to query spatial bins with.
+  Math::Vector2d GetHalfSizes() const {
+    return Math::Vector2d((float)(i_end - i_begin) * 0.5f,
+                          (float)(j_end - j_begin) * 0.5f);
+  }
+
+  int i_begin{0};
+  int j_begin{0};
+  int i_end{0};
+  int j_end{0};
+};
+
+// Opening between two sectors, a segment on their common border.
+struct Portal {
+  Math::Segment2d segment;
+  int sectors[2]{-1, -1};
+};
+
+// Level split into sectors connected by portals, built once when the level
+// is loaded.
+class SectorMap {
+ public:
+  SectorMap() {}
+
+  /// \arg width, height Tile map size.
+  SectorMap(int width, int height)
+      : width_(width),
+        height_(height),
+        tile_sectors_((size_t)width * height, -1) {}
+
+  /// Tiles already in a sector move to the new one. Returns its index.
+  int AddSector(int i_begin, int j_begin, int i_end, int j_end) {
+    Sector sector;
+    sector.i_begin = std::max(i_begin, 0);
+    sector.j_begin = std::max(j_begin, 0);
+    sector.i_end = std::min(i_end, width_);
+    sector.j_end = std::min(j_end, height_);
+    int index = (int)sectors_.size();
+    sectors_.push_back(sector);
+    sector_portals_.emplace_back();
+    for (int j = sector.j_begin; j < sector.j_end; ++j) {
+      for (int i = sector.i_begin; i < sector.i_end; ++i) {
+        tile_sectors_[(size_t)j * width_ + i] = index;
+      }
+    }
+    return index;
+  }
+
+  void AddPortal(int sector_a, int sector_b, const Math::Segment2d& segment) {
+    Portal portal;
+    portal.segment = segment;
+    portal.sectors[0] = sector_a;
+    portal.sectors[1] = sector_b;
+    int index = (int)portals_.size();
+    portals_.push_back(portal);
+    sector_portals_[sector_a].push_back(index);
+    sector_portals_[sector_b].push_back(index);
+  }
+
+  int GetNumSectors() const { return (int)sectors_.size(); }
+
+  const Sector& GetSector(int sector) const { return sectors_[sector]; }
+
+  const Portal& GetPortal(int portal) const { return portals_[portal]; }
+
+  /// Indices of the portals of the sector.
+  const std::vector<int>& GetSectorPortals(int sector) const {
+    return sector_portals_[sector];
+  }
+
+  /// Sector of the tile or -1.
+  int GetTileSector(int i, int j) const {
+    if (i < 0 || j < 0 || i >= width_ || j >= height_) {
+      return -1;
+    }
+    return tile_sectors_[(size_t)j * width_ + i];
+  }
+
+  /// Sector containing the point or -1.
+  int FindSector(const Math::Point2d& p) const {
+    return GetTileSector((int)floorf(p.x), (int)floorf(p.y));
+  }
+
+ private:
+  int width_{0};
+  int height_{0};
+  std::vector<int> tile_sectors_;
+  std::vector<Sector> sectors_;
+  std::vector<Portal> portals_;
+  std::vector<std::vector<int>> sector_portals_;
+};
+
+// Sectors seen by the camera this frame. Starting from the camera sector,
+// every portal is projected and clipped to the screen range it is seen
+// through, only sectors behind a non-empty range are visited. Cells and
+// objects of the other sectors can be skipped, and the farthest visible
+// sector caps how far rays have to travel.
+class PortalVisibility {
+ public:
+  /// Portal points closer than this to the camera plane are clipped.
+  static constexpr float kNearDistance = 0.01f;
+
+  struct VisibleSector {
+    int sector;
+    /// Screen x range it is seen through, union over all portal paths.
+    float screen_x_min;
+    float screen_x_max;
+  };
+
+  void Update(const RayCastingProjection& projection, const SectorMap& map) {
+    visible_.clear();
+    sector_visible_index_.assign(map.GetNumSectors(), -1);
+    covered_.resize(map.GetNumSectors());
+    for (auto& covered : covered_) {
+      covered.clear();
+    }
+    max_distance_ = 0.0f;
+
+    int camera_sector = map.FindSector(projection.GetCameraOrigin());
+    if (camera_sector < 0) {
+      return;
+    }
+    work_.clear();
+    work_.push_back(ScreenRange{camera_sector, -1.0f, 1.0f});
+    while (!work_.empty()) {
+      ScreenRange item = work_.back();
+      work_.pop_back();
+      visit(projection, map, item);
+    }
+  }
+
+  /// In the order they were first reached, the camera sector first.
+  const std::vector<VisibleSector>& GetVisibleSectors() const {
+    return visible_;
+  }
+
+  bool IsSectorVisible(int sector) const {
+    return sector_visible_index_[sector] >= 0;
+  }
+
+  bool IsCellVisible(const SectorMap& map, int i, int j) const {
+    int sector = map.GetTileSector(i, j);
+    return sector >= 0 && IsSectorVisible(sector);
+  }
+
+  /// True when the sector of p is visible. Objects outside of the screen
+  /// range of their sector still pass, per object frustum culling is left
+  /// to the caller.
+  bool IsPointVisible(const SectorMap& map, const Math::Point2d& p) const {
+    int sector = map.FindSector(p);
+    return sector >= 0 && IsSectorVisible(sector);
+  }
+
+  /// Distance from the camera to the farthest corner of a visible sector.
+  /// Nothing visible is farther, use it to cap
+  /// RayCastingParameters::max_distance.
+  float GetMaxDistance() const { return max_distance_; }
+
+ private:
+  struct ScreenRange {
+    int sector;
+    float x_min;
+    float x_max;
+  };
+
+  // Every sector is entered once per part of the screen: only the parts
+  // of the range not covered by earlier visits are looked through. Loops
+  // of sectors end, and grids of rooms with many doors stay linear instead
+  // of enumerating every path.
+  void visit(const RayCastingProjection& projection, const SectorMap& map,
+             const ScreenRange& item) {
+    int sector = item.sector;
+    uncovered_.clear();
+    subtractCovered(covered_[sector], item.x_min, item.x_max, uncovered_);
+    if (uncovered_.empty()) {
+      return;
+    }
+    for (const ScreenRange& part : uncovered_) {
+      markVisible(projection, map, sector, part.x_min, part.x_max);
+    }
+    addCovered(covered_[sector], item.x_min, item.x_max);
+
+    // Reversed on the stack, so portals are entered in order.
+    const std::vector<int>& portals = map.GetSectorPortals(sector);
+    for (int k = (int)portals.size() - 1; k >= 0; --k) {
+      const Portal& portal = map.GetPortal(portals[k]);
+      int next = portal.sectors[0] == sector ? portal.sectors[1]
+                                             : portal.sectors[0];
+
+      float portal_x_min = 0.0f;
+      float portal_x_max = 0.0f;
+      if (!projectPortal(projection, portal.segment, portal_x_min,
+                         portal_x_max)) {
+        continue;
+      }
+      for (int p = (int)uncovered_.size() - 1; p >= 0; --p) {
+        float x_min = std::max(portal_x_min, uncovered_[p].x_min);
+        float x_max = std::min(portal_x_max, uncovered_[p].x_max);
+        if (x_min < x_max) {
+          work_.push_back(ScreenRange{next, x_min, x_max});
+        }
+      }
+    }
+  }
+
+  // Parts of [x_min, x_max] outside of the sorted disjoint ranges of
+  // covered.
+  static void subtractCovered(const std::vector<ScreenRange>& covered,
+                              float x_min, float x_max,
+                              std::vector<ScreenRange>& parts_out) {
+    float cursor = x_min;
+    for (const ScreenRange& range : covered) {
+      if (range.x_max <= cursor) {
+        continue;
+      }
+      if (range.x_min >= x_max) {
+        break;
+      }
+      if (range.x_min > cursor) {
+        parts_out.push_back(ScreenRange{-1, cursor, range.x_min});
+      }
+      cursor = range.x_max;
+    }
+    if (cursor < x_max) {
+      parts_out.push_back(ScreenRange{-1, cursor, x_max});
+    }
+  }
+
+  static void addCovered(std::vector<ScreenRange>& covered, float x_min,
+                         float x_max) {
+    auto begin = std::lower_bound(
+        covered.begin(), covered.end(), x_min,
+        [](const ScreenRange& range, float x) { return range.x_max < x; });
+    auto end = begin;
+    while (end != covered.end() && end->x_min <= x_max) {
+      x_min = std::min(x_min, end->x_min);
+      x_max = std::max(x_max, end->x_max);
+      ++end;
+    }
+    begin = covered.erase(begin, end);
+    covered.insert(begin, ScreenRange{-1, x_min, x_max});
+  }
+
+  void markVisible(const RayCastingProjection& projection,
+                   const SectorMap& map, int sector, float x_min,
+                   float x_max) {
+    int index = sector_visible_index_[sector];
+    if (index >= 0) {
+      visible_[index].screen_x_min =
+          std::min(visible_[index].screen_x_min, x_min);
+      visible_[index].screen_x_max =
+          std::max(visible_[index].screen_x_max, x_max);
+      return;
+    }
+
+    sector_visible_index_[sector] = (int)visible_.size();
+    visible_.push_back(VisibleSector{sector, x_min, x_max});
+
+    const Sector& rect = map.GetSector(sector);
+    const Math::Point2d& origin = projection.GetCameraOrigin();
+    float dx = std::max(fabsf((float)rect.i_begin - origin.x),
+                        fabsf((float)rect.i_end - origin.x));
+    float dy = std::max(fabsf((float)rect.j_begin - origin.y),
+                        fabsf((float)rect.j_end - origin.y));
+    max_distance_ = std::max(max_distance_, sqrtf(dx * dx + dy * dy));
+  }
+
+  // Screen x range covered by the segment, clipped to the near plane.
+  // Returns false when it is entirely behind the camera.
+  static bool projectPortal(const RayCastingProjection& projection,
+                            const Math::Segment2d& segment,
+                            float& x_min_out, float& x_max_out) {
+    const Math::Point2d& origin = projection.GetCameraOrigin();
+    const Math::Vector2d& forward = projection.GetCameraDirection();
+    const Math::Vector2d& right = projection.GetCameraRight();
+
+    // Standing in the opening: it covers whatever is in front.
+    if (getDistanceSq(segment, origin) < kNearDistance * kNearDistance) {
+      x_min_out = -1.0f;
+      x_max_out = 1.0f;
+      return true;
+    }
+
+    Math::Vector2d v0 = segment.p0 - origin;
+    Math::Vector2d v1 = segment.p1 - origin;
+    float depth0 = v0 * forward;
+    float depth1 = v1 * forward;
+    if (depth0 < kNearDistance && depth1 < kNearDistance) {
+      return false;
+    }
+
+    float side0 = v0 * right;
+    float side1 = v1 * right;
+    if (depth0 < kNearDistance || depth1 < kNearDistance) {
+      float t = (kNearDistance - depth0) / (depth1 - depth0);
+      float side = side0 + (side1 - side0) * t;
+      if (depth0 < kNearDistance) {
+        depth0 = kNearDistance;
+        side0 = side;
+      } else {
+        depth1 = kNearDistance;
+        side1 = side;
+      }
+    }
+
+    float camera_z = projection.GetCameraZ();
+    float x0 = projection
+                   .Project(origin + right * side0 + forward * depth0,
+                            camera_z)
+                   .x;
+    float x1 = projection
+                   .Project(origin + right * side1 + forward * depth1,
+                            camera_z)
+                   .x;
+    x_min_out = std::min(x0, x1);
+    x_max_out = std::max(x0, x1);
+    return true;
+  }
+
+  static float getDistanceSq(const Math::Segment2d& segment,
+                             const Math::Point2d& p) {
+    Math::Vector2d v = segment.p1 - segment.p0;
+    float length_sq = v.GetLengthSq();
+    float t = 0.0f;
+    if (length_sq > 0.0f) {
+      t = std::clamp(((p - segment.p0) * v) / length_sq, 0.0f, 1.0f);
+    }
+    return (p - (segment.p0 + v * t)).GetLengthSq();
+  }
+
+  std::vector<VisibleSector> visible_;
+  // Index in visible_ or -1.
+  std::vector<int> sector_visible_index_;
+  // Per sector, sorted disjoint screen ranges already looked through.
+  std::vector<std::vector<ScreenRange>> covered_;
+  std::vector<ScreenRange> work_;
+  std::vector<ScreenRange> uncovered_;
+  float max_distance_{0.0f};
+};
+}  // namespace Visibility
+}  // namespace Symphony
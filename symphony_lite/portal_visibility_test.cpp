@@ -0,0 +1,187 @@
+#include "portal_visibility.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Symphony::Math;
+using namespace Symphony::Visibility;
+
+namespace {
+// Three 4x4 rooms in a row along x with doors at y in [1.5, 2.5], and a
+// room north of the first one.
+class PortalVisibilityTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    map_ = SectorMap(12, 8);
+    a_ = map_.AddSector(0, 0, 4, 4);
+    b_ = map_.AddSector(4, 0, 8, 4);
+    c_ = map_.AddSector(8, 0, 12, 4);
+    d_ = map_.AddSector(0, 4, 4, 8);
+    map_.AddPortal(a_, b_,
+                   Segment2d(Point2d(4.0f, 1.5f), Point2d(4.0f, 2.5f)));
+    map_.AddPortal(d_, a_,
+                   Segment2d(Point2d(1.5f, 4.0f), Point2d(2.5f, 4.0f)));
+  }
+
+  void update(const Point2d& origin, const Vector2d& direction) {
+    projection_.SetCamera(origin, 0.5f, direction);
+    visibility_.Update(projection_, map_);
+  }
+
+  SectorMap map_;
+  int a_ = 0;
+  int b_ = 0;
+  int c_ = 0;
+  int d_ = 0;
+  RayCastingProjection projection_{64, 48, 90.0f};
+  PortalVisibility visibility_;
+};
+}  // namespace
+
+TEST_F(PortalVisibilityTest, FindSector) {
+  EXPECT_EQ(a_, map_.FindSector(Point2d(0.5f, 0.5f)));
+  EXPECT_EQ(b_, map_.FindSector(Point2d(4.0f, 2.0f)));
+  EXPECT_EQ(d_, map_.FindSector(Point2d(3.9f, 7.9f)));
+  EXPECT_EQ(-1, map_.FindSector(Point2d(12.5f, 2.0f)));
+  EXPECT_EQ(-1, map_.FindSector(Point2d(-0.5f, 2.0f)));
+}
+
+TEST_F(PortalVisibilityTest, ThroughChainOfPortals) {
+  map_.AddPortal(b_, c_,
+                 Segment2d(Point2d(8.0f, 1.5f), Point2d(8.0f, 2.5f)));
+  update(Point2d(2.0f, 2.0f), Vector2d(1.0f, 0.0f));
+
+  EXPECT_TRUE(visibility_.IsSectorVisible(a_));
+  EXPECT_TRUE(visibility_.IsSectorVisible(b_));
+  EXPECT_TRUE(visibility_.IsSectorVisible(c_));
+  EXPECT_FALSE(visibility_.IsSectorVisible(d_));
+  EXPECT_TRUE(visibility_.IsCellVisible(map_, 10, 3));
+  EXPECT_FALSE(visibility_.IsCellVisible(map_, 1, 6));
+  EXPECT_TRUE(visibility_.IsPointVisible(map_, Point2d(9.0f, 1.0f)));
+  EXPECT_FALSE(visibility_.IsPointVisible(map_, Point2d(1.0f, 5.0f)));
+
+  // Door 2 units ahead and 1 unit wide, 90 degree fov.
+  const std::vector<PortalVisibility::VisibleSector>& visible =
+      visibility_.GetVisibleSectors();
+  ASSERT_EQ(3, (int)visible.size());
+  EXPECT_EQ(a_, visible[0].sector);
+  EXPECT_EQ(-1.0f, visible[0].screen_x_min);
+  EXPECT_EQ(1.0f, visible[0].screen_x_max);
+  EXPECT_EQ(b_, visible[1].sector);
+  EXPECT_NEAR(-0.25f, visible[1].screen_x_min, 1e-5f);
+  EXPECT_NEAR(0.25f, visible[1].screen_x_max, 1e-5f);
+  EXPECT_EQ(c_, visible[2].sector);
+  EXPECT_NEAR(-0.0833f, visible[2].screen_x_min, 1e-3f);
+  EXPECT_NEAR(0.0833f, visible[2].screen_x_max, 1e-3f);
+
+  // Far corner of c.
+  EXPECT_NEAR(sqrtf(10.0f * 10.0f + 2.0f * 2.0f),
+              visibility_.GetMaxDistance(), 1e-4f);
+}
+
+TEST_F(PortalVisibilityTest, PortalOutsideOfWindow) {
+  // In the frustum, but not through the first door.
+  map_.AddPortal(b_, c_,
+                 Segment2d(Point2d(8.0f, 3.6f), Point2d(8.0f, 3.9f)));
+  update(Point2d(2.0f, 2.0f), Vector2d(1.0f, 0.0f));
+
+  EXPECT_TRUE(visibility_.IsSectorVisible(b_));
+  EXPECT_FALSE(visibility_.IsSectorVisible(c_));
+}
+
+TEST_F(PortalVisibilityTest, BehindCamera) {
+  update(Point2d(2.0f, 2.0f), Vector2d(-1.0f, 0.0f));
+
+  ASSERT_EQ(1, (int)visibility_.GetVisibleSectors().size());
+  EXPECT_TRUE(visibility_.IsSectorVisible(a_));
+  EXPECT_NEAR(sqrtf(8.0f), visibility_.GetMaxDistance(), 1e-4f);
+}
+
+TEST_F(PortalVisibilityTest, StandingInDoor) {
+  // On the border of a and b, looking along it.
+  update(Point2d(4.0f, 2.0f), Vector2d(0.0f, 1.0f));
+
+  EXPECT_TRUE(visibility_.IsSectorVisible(a_));
+  EXPECT_TRUE(visibility_.IsSectorVisible(b_));
+}
+
+TEST_F(PortalVisibilityTest, PortalCrossingNearPlane) {
+  // Door of d runs from behind the camera to its left.
+  update(Point2d(2.0f, 3.8f), Vector2d(1.0f, 0.0f));
+
+  EXPECT_TRUE(visibility_.IsSectorVisible(d_));
+  const std::vector<PortalVisibility::VisibleSector>& visible =
+      visibility_.GetVisibleSectors();
+  ASSERT_EQ(3, (int)visible.size());
+  EXPECT_EQ(d_, visible[2].sector);
+  // Clipped end projects far outside of the screen.
+  EXPECT_TRUE(visible[2].screen_x_min == -1.0f ||
+              visible[2].screen_x_max == 1.0f);
+}
+
+TEST(PortalVisibility, LoopedRoomGrid) {
+  // 16x16 rooms of 2x2 tiles, every shared wall is a door, so most rooms
+  // are reached over many looped paths.
+  const int kNumRooms = 16;
+  const int kRoomSize = 2;
+  SectorMap map(kNumRooms * kRoomSize, kNumRooms * kRoomSize);
+  for (int j = 0; j < kNumRooms; ++j) {
+    for (int i = 0; i < kNumRooms; ++i) {
+      map.AddSector(i * kRoomSize, j * kRoomSize, (i + 1) * kRoomSize,
+                    (j + 1) * kRoomSize);
+    }
+  }
+  for (int j = 0; j < kNumRooms; ++j) {
+    for (int i = 0; i < kNumRooms; ++i) {
+      int room = j * kNumRooms + i;
+      float x = (float)((i + 1) * kRoomSize);
+      float y = (float)((j + 1) * kRoomSize);
+      if (i + 1 < kNumRooms) {
+        map.AddPortal(room, room + 1,
+                      Segment2d(Point2d(x, y - (float)kRoomSize),
+                                Point2d(x, y)));
+      }
+      if (j + 1 < kNumRooms) {
+        map.AddPortal(room, room + kNumRooms,
+                      Segment2d(Point2d(x - (float)kRoomSize, y),
+                                Point2d(x, y)));
+      }
+    }
+  }
+
+  Point2d origin(16.3f, 16.1f);
+  RayCastingProjection projection(64, 48, 90.0f);
+  projection.SetCamera(origin, 0.5f, Vector2d(1.0f, 0.0f));
+  PortalVisibility visibility;
+  visibility.Update(projection, map);
+
+  // Nothing blocks the view, so exactly the rooms overlapping the 90 degree
+  // frustum are visible: somewhere |dy| < dx.
+  int camera_sector = map.FindSector(origin);
+  for (int sector = 0; sector < map.GetNumSectors(); ++sector) {
+    const Sector& rect = map.GetSector(sector);
+    float max_dx = (float)rect.i_end - origin.x;
+    float min_abs_dy = 0.0f;
+    if (origin.y < (float)rect.j_begin) {
+      min_abs_dy = (float)rect.j_begin - origin.y;
+    } else if (origin.y > (float)rect.j_end) {
+      min_abs_dy = origin.y - (float)rect.j_end;
+    }
+    bool in_frustum = min_abs_dy < max_dx;
+    EXPECT_EQ(in_frustum || sector == camera_sector,
+              visibility.IsSectorVisible(sector))
+        << "sector " << sector;
+  }
+}
+
+TEST(PortalVisibility, ManySectors) {
+  // One sector per tile, more than int16_t can index.
+  SectorMap map(200, 200);
+  for (int j = 0; j < 200; ++j) {
+    for (int i = 0; i < 200; ++i) {
+      map.AddSector(i, j, i + 1, j + 1);
+    }
+  }
+  EXPECT_EQ(40000, map.GetNumSectors());
+  EXPECT_EQ(39999, map.GetTileSector(199, 199));
+  EXPECT_EQ(32768, map.GetTileSector(168, 163));
+}
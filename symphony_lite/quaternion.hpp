@@ -0,0 +1,153 @@
+#pragma once
+
+#include <math.h>
+
+#include <vector>
+
+#include "vector3d.hpp"
+
+namespace Symphony {
+namespace Math {
+// Unit quaternions represent rotations, q * p rotates by p first and then
+// by q, like matrices.
+class Quaternion {
+ public:
+  constexpr Quaternion() : w(1.0f), x(0.0f), y(0.0f), z(0.0f) {}
+
+  constexpr Quaternion(float new_w, float new_x, float new_y, float new_z)
+      : w(new_w), x(new_x), y(new_y), z(new_z) {}
+
+  Quaternion(const Vector3d& axis_norm, float angle_rad) {
+    MakeRotation(axis_norm, angle_rad);
+  }
+
+  void MakeIdentity() {
+    w = 1.0f;
+    x = 0.0f;
+    y = 0.0f;
+    z = 0.0f;
+  }
+
+  /// Counter clockwise rotation around axis when looking against it.
+  void MakeRotation(const Vector3d& axis_norm, float angle_rad) {
+    float half_angle = angle_rad * 0.5f;
+    float s = sinf(half_angle);
+    w = cosf(half_angle);
+    x = axis_norm.x * s;
+    y = axis_norm.y * s;
+    z = axis_norm.z * s;
+  }
+
+  constexpr Quaternion operator*(const Quaternion& rhv) const {
+    return Multiply(rhv);
+  }
+
+  constexpr Quaternion Multiply(const Quaternion& rhv) const {
+    return Quaternion(w * rhv.w - x * rhv.x - y * rhv.y - z * rhv.z,
+                      w * rhv.x + x * rhv.w + y * rhv.z - z * rhv.y,
+                      w * rhv.y - x * rhv.z + y * rhv.w + z * rhv.x,
+                      w * rhv.z + x * rhv.y - y * rhv.x + z * rhv.w);
+  }
+
+  constexpr Quaternion operator-() const { return Quaternion(-w, -x, -y, -z); }
+
+  constexpr float Dot(const Quaternion& rhv) const {
+    return w * rhv.w + x * rhv.x + y * rhv.y + z * rhv.z;
+  }
+
+  /// Inverse rotation for unit quaternions.
+  constexpr Quaternion GetConjugate() const {
+    return Quaternion(w, -x, -y, -z);
+  }
+
+  constexpr float GetLengthSq() const { return Dot(*this); }
+
+  float GetLength() const { return sqrtf(GetLengthSq()); }
+
+  void MakeNormalized() {
+    float l_inv = 1.0f / GetLength();
+    w *= l_inv;
+    x *= l_inv;
+    y *= l_inv;
+    z *= l_inv;
+  }
+
+  Quaternion GetNormalized() const {
+    Quaternion q(w, x, y, z);
+    q.MakeNormalized();
+    return q;
+  }
+
+  constexpr Vector3d Rotate(const Vector3d& v) const {
+    // v + 2 * r x (r x v + w * v), where r is the vector part.
+    Vector3d r(x, y, z);
+    Vector3d t = r.Cross(v) * 2.0f;
+    return v + t * w + r.Cross(t);
+  }
+
+  float w;
+  float x;
+  float y;
+  float z;
+};
+
+/// Normalized linear interpolation along the shorter arc. Not constant
+/// speed, but cheap and close to Slerp for the small steps of animation.
+inline Quaternion Nlerp(const Quaternion& from, const Quaternion& to,
+                        float t) {
+  float to_t = from.Dot(to) < 0.0f ? -t : t;
+  float from_t = 1.0f - t;
+  Quaternion result(from.w * from_t + to.w * to_t,
+                    from.x * from_t + to.x * to_t,
+                    from.y * from_t + to.y * to_t,
+                    from.z * from_t + to.z * to_t);
+  result.MakeNormalized();
+  return result;
+}
+
+/// Constant speed interpolation along the shorter arc.
+inline Quaternion Slerp(const Quaternion& from, const Quaternion& to,
+                        float t) {
+  float cos_angle = from.Dot(to);
+  Quaternion end = to;
+  if (cos_angle < 0.0f) {
+    cos_angle = -cos_angle;
+    end = -to;
+  }
+
+  // sin of a tiny angle loses precision, both are the same there.
+  if (cos_angle > 0.9995f) {
+    return Nlerp(from, end, t);
+  }
+
+  float angle = acosf(cos_angle);
+  float sin_angle_inv = 1.0f / sinf(angle);
+  float from_t = sinf((1.0f - t) * angle) * sin_angle_inv;
+  float to_t = sinf(t * angle) * sin_angle_inv;
+  return Quaternion(from.w * from_t + end.w * to_t,
+                    from.x * from_t + end.x * to_t,
+                    from.y * from_t + end.y * to_t,
+                    from.z * from_t + end.z * to_t);
+}
+
+/// Nlerp for a whole rig (all bones of a skeleton, all parts of a sprite
+/// rig) with the same t. Branch free so the compiler can vectorize it.
+inline void Nlerp(const std::vector<Quaternion>& from,
+                  const std::vector<Quaternion>& to, float t,
+                  std::vector<Quaternion>& result_out) {
+  result_out.resize(from.size());
+  float from_t = 1.0f - t;
+  for (int i = 0; i < (int)from.size(); ++i) {
+    const Quaternion& a = from[i];
+    const Quaternion& b = to[i];
+    float to_t = copysignf(t, a.Dot(b));
+    float w = a.w * from_t + b.w * to_t;
+    float x = a.x * from_t + b.x * to_t;
+    float y = a.y * from_t + b.y * to_t;
+    float z = a.z * from_t + b.z * to_t;
+    float l_inv = 1.0f / sqrtf(w * w + x * x + y * y + z * z);
+    result_out[i] = Quaternion(w * l_inv, x * l_inv, y * l_inv, z * l_inv);
+  }
+}
+}  // namespace Math
+}  // namespace Symphony
@@ -0,0 +1,97 @@
+#include "quaternion.hpp"
+
+#include <gtest/gtest.h>
+
+#include "angle.hpp"
+#include "transformation_matrix3d.hpp"
+
+using namespace Symphony::Math;
+
+TEST(Quaternion, Rotate) {
+  Quaternion q(Vector3d(0.0f, 0.0f, 1.0f), DegToRad(90.0f));
+  Vector3d v = q.Rotate(Vector3d(1.0f, 0.0f, 0.0f));
+  ASSERT_NEAR(0.0f, v.x, 0.0001f);
+  ASSERT_NEAR(1.0f, v.y, 0.0001f);
+  ASSERT_NEAR(0.0f, v.z, 0.0001f);
+
+  v = q.GetConjugate().Rotate(v);
+  ASSERT_NEAR(1.0f, v.x, 0.0001f);
+  ASSERT_NEAR(0.0f, v.y, 0.0001f);
+}
+
+TEST(Quaternion, Compose) {
+  Quaternion around_z(Vector3d(0.0f, 0.0f, 1.0f), DegToRad(90.0f));
+  Quaternion around_x(Vector3d(1.0f, 0.0f, 0.0f), DegToRad(90.0f));
+
+  // First around z: x -> y, then around x: y -> z.
+  Vector3d v = (around_x * around_z).Rotate(Vector3d(1.0f, 0.0f, 0.0f));
+  ASSERT_NEAR(0.0f, v.x, 0.0001f);
+  ASSERT_NEAR(0.0f, v.y, 0.0001f);
+  ASSERT_NEAR(1.0f, v.z, 0.0001f);
+}
+
+TEST(Quaternion, Interpolation) {
+  Vector3d axis(0.0f, 1.0f, 0.0f);
+  Quaternion from(axis, 0.0f);
+  Quaternion to(axis, DegToRad(120.0f));
+
+  Quaternion half = Slerp(from, to, 0.5f);
+  Quaternion expected(axis, DegToRad(60.0f));
+  ASSERT_NEAR(1.0f, fabsf(half.Dot(expected)), 0.0001f);
+
+  half = Nlerp(from, to, 0.5f);
+  ASSERT_NEAR(1.0f, fabsf(half.Dot(expected)), 0.0001f);
+
+  // Takes the shorter arc when the signs differ.
+  half = Slerp(from, -to, 0.5f);
+  ASSERT_NEAR(1.0f, fabsf(half.Dot(expected)), 0.0001f);
+
+  std::vector<Quaternion> froms = {from, from, to};
+  std::vector<Quaternion> tos = {to, -to, from};
+  std::vector<Quaternion> result;
+  Nlerp(froms, tos, 0.25f, result);
+  ASSERT_EQ(3, (int)result.size());
+  for (int i = 0; i < 3; ++i) {
+    Quaternion single = Nlerp(froms[i], tos[i], 0.25f);
+    ASSERT_NEAR(1.0f, fabsf(result[i].Dot(single)), 0.0001f);
+    ASSERT_NEAR(1.0f, result[i].GetLength(), 0.0001f);
+  }
+}
+
+TEST(Quaternion, MatrixMatchesRotate) {
+  Quaternion q =
+      Quaternion(Vector3d(1.0f, 2.0f, 3.0f).GetNormalized(), 0.7f) *
+      Quaternion(Vector3d(0.0f, 1.0f, 0.0f), -1.3f);
+  TransformationMatrix3d m;
+  m.MakeRotation(q);
+
+  Vector3d v(0.5f, -2.0f, 1.5f);
+  Vector3d expected = q.Rotate(v);
+  Vector3d rotated = m.Transform(v, 0.0f);
+  ASSERT_NEAR(expected.x, rotated.x, 0.0001f);
+  ASSERT_NEAR(expected.y, rotated.y, 0.0001f);
+  ASSERT_NEAR(expected.z, rotated.z, 0.0001f);
+}
+
+TEST(Quaternion, TransformationMatchesMultiplies) {
+  Vector3d translate(1.0f, 2.0f, 3.0f);
+  Quaternion q(Vector3d(1.0f, 1.0f, 0.0f).GetNormalized(), 0.4f);
+  Vector3d scale(2.0f, 3.0f, 4.0f);
+
+  TransformationMatrix3d trs;
+  trs.MakeTransformation(translate, q, scale);
+
+  TransformationMatrix3d t;
+  t.MakeTranslation(translate);
+  TransformationMatrix3d r;
+  r.MakeRotation(q);
+  TransformationMatrix3d s;
+  s.MakeScale(scale);
+  TransformationMatrix3d expected = t * r * s;
+
+  const float* trs_values = &trs.m11;
+  const float* expected_values = &expected.m11;
+  for (int i = 0; i < TransformationMatrix3d::kSize; ++i) {
+    ASSERT_NEAR(expected_values[i], trs_values[i], 0.0001f);
+  }
+}
@@ -7,7 +7,7 @@ class RandomGenerator {
   RandomGenerator() {}
 
   void SetSeed(long seed) {
-    current_value_ = seed;
+    current_value_ = (unsigned long)seed;
     NextValue();
   }
 
@@ -18,8 +18,15 @@ class RandomGenerator {
 
   unsigned int MaxValue() const { return 0x7FFF - 1; }
 
+  /// Uniform in [min_value, max_value].
+  float NextFloat(float min_value, float max_value) {
+    return min_value +
+           (max_value - min_value) * (float)NextValue() / (float)0x7FFF;
+  }
+
  private:
-  long current_value_{0};
+  // Unsigned, so the multiplication wraps instead of overflowing.
+  unsigned long current_value_{0};
 };
 }  // namespace Random
 }  // namespace Symphony
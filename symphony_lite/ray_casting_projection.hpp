@@ -1,12 +1,44 @@
 #pragma once
 
+#include <array>
+#include <span>
 #include <vector>
 
+#include "aligned_allocator.hpp"
 #include "angle.hpp"
+#include "constexpr_math.hpp"
 #include "point2d.hpp"
+#include "simd.hpp"
 
 namespace Symphony {
 namespace Visibility {
+/// Camera space rays for every screen column, the same
+/// RayCastingProjection builds in SetViewport. Bake it for common
+/// resolutions:
+///   constexpr auto kRays400 = MakeRayTable<400>(90.0f);
+template <int kScreenWidth>
+struct RayTable {
+  float horizontal_fov_deg{0.0f};
+  float horizontal_half_fov_tan_inv{0.0f};
+  std::array<Math::Vector2d, kScreenWidth> rays;
+};
+
+template <int kScreenWidth>
+constexpr RayTable<kScreenWidth> MakeRayTable(float horizontal_fov_deg) {
+  RayTable<kScreenWidth> result;
+  result.horizontal_fov_deg = horizontal_fov_deg;
+  result.horizontal_half_fov_tan_inv =
+      1.0f / Math::Constexpr::Tan(Math::DegToRad(horizontal_fov_deg / 2.0f));
+
+  int screen_half_width = kScreenWidth / 2;
+  for (int i = 0; i < kScreenWidth; ++i) {
+    float x = ((float)(i - screen_half_width) / (float)screen_half_width) *
+              result.horizontal_half_fov_tan_inv;
+    float length = Math::Constexpr::Sqrt(x * x + 1.0f);
+    result.rays[i] = Math::Vector2d(x / length, 1.0f / length);
+  }
+  return result;
+}
 
 class RayCastingProjection {
  public:
@@ -28,6 +60,28 @@ class RayCastingProjection {
     rebuildRayDeltas();
   }
 
+  /// Same as SetViewport, but copies rays from a baked table instead of
+  /// computing them.
+  template <int kScreenWidth>
+  void SetViewport(const RayTable<kScreenWidth>& ray_table,
+                   int screen_height) {
+    screen_width_ = (float)kScreenWidth;
+    screen_height_ = (float)screen_height;
+    aspect_ratio_ = (float)kScreenWidth / (float)screen_height;
+    horizontal_half_fov_deg_ = ray_table.horizontal_fov_deg / 2.0f;
+    horizontal_half_fov_tan_inv_ = ray_table.horizontal_half_fov_tan_inv;
+    screen_half_width_ = kScreenWidth / 2;
+    half_rays_.assign(ray_table.rays.begin() + screen_half_width_,
+                      ray_table.rays.end());
+    // Odd widths already have screen_half_width_ + 1 half rays. Even widths
+    // miss the rightmost one, it mirrors column 0.
+    if ((int)half_rays_.size() == screen_half_width_) {
+      half_rays_.push_back(Math::Vector2d(-ray_table.rays[0].x,
+                                          ray_table.rays[0].y));
+    }
+    rebuildProjectionFactors();
+  }
+
   void SetCamera(const Math::Point2d& origin, float origin_z,
                  const Math::Vector2d& camera_direction_norm) {
     camera_origin_ = origin;
@@ -40,7 +94,8 @@ class RayCastingProjection {
   /// \arg v Ray vector in camera space.
   /// \arg d Distance along vector v to point to project.
   /// \arg p_z z coordinate of the point to project in world space.
-  Math::Point2d Project(const Math::Vector2d& v_norm, float d, float p_z) {
+  Math::Point2d Project(const Math::Vector2d& v_norm, float d,
+                        float p_z) const {
     float dx = v_norm.x * d;
     float dy = v_norm.y * d;
     float dz = p_z - camera_z_;
@@ -50,7 +105,7 @@ class RayCastingProjection {
   }
 
   /// \arg p Point to project in world space.
-  Math::Point2d Project(const Math::Point2d& p, float p_z) {
+  Math::Point2d Project(const Math::Point2d& p, float p_z) const {
     Math::Vector2d to_p = p - camera_origin_;
     float dx = to_p * camera_right_norm_;
     float dy = to_p * camera_direction_norm_;
@@ -58,35 +113,94 @@ class RayCastingProjection {
   }
 
   Math::Vector2d GetRayWorld(int ray_index) const {
-    int screen_half_width = (int)(screen_width_ / 2.0f);
-    float x =
-        ((float)(ray_index - screen_half_width) / (float)screen_half_width) *
-        horizontal_half_fov_tan_inv_;
-    return (camera_right_norm_ * x + camera_direction_norm_) *
-           ray_lengths_inv_[ray_index];
+    Math::Vector2d ray = getRay(ray_index);
+    return camera_right_norm_ * ray.x + camera_direction_norm_ * ray.y;
+  }
+
+  /// Same as Project(rays[ray_index], d, p_z) with one division.
+  Math::Point2d Project(int ray_index, float d, float p_z) const {
+    return Math::Point2d(
+        getScreenX(ray_index),
+        (p_z - camera_z_) * projection_factors_[ray_index] / d);
+  }
+
+  /// Project for every column at once: result_out[i] is the projection of
+  /// the point at distances[i] along ray i and height p_z.
+  void ProjectColumns(std::span<const float> distances, float p_z,
+                      std::span<Math::Point2d> result_out) const {
+    const int kLanes = Simd::Float::kLanes;
+    int size = std::min((int)distances.size(), (int)result_out.size());
+    float dz = p_z - camera_z_;
+
+    int i = 0;
+    Simd::Float dz_lanes = Simd::Float::Set(dz);
+    alignas(32) float screen_y[kLanes];
+    for (; i + kLanes <= size; i += kLanes) {
+      Simd::Float y = dz_lanes *
+                      Simd::Float::LoadAligned(&projection_factors_[i]) *
+                      Simd::Rcp(Simd::Float::Load(&distances[i]));
+      y.StoreAligned(screen_y);
+      for (int k = 0; k < kLanes; ++k) {
+        result_out[i + k] = Math::Point2d(getScreenX(i + k), screen_y[k]);
+      }
+    }
+    for (; i < size; ++i) {
+      result_out[i] = Math::Point2d(
+          getScreenX(i), dz * projection_factors_[i] / distances[i]);
+    }
   }
 
-  Math::Point2d Project(int ray_index, float d, float p_z) {
-    return Project(/* v_norm= */ rays_[ray_index], d, p_z);
+  int GetScreenWidth() const { return (int)screen_width_; }
+
+  int GetScreenHeight() const { return (int)screen_height_; }
+
+  const Math::Point2d& GetCameraOrigin() const { return camera_origin_; }
+
+  float GetCameraZ() const { return camera_z_; }
+
+  const Math::Vector2d& GetCameraDirection() const {
+    return camera_direction_norm_;
   }
 
+  const Math::Vector2d& GetCameraRight() const { return camera_right_norm_; }
+
  private:
+  // Rays are symmetric around the screen center, only the right half is
+  // stored: half_rays_[k] is the ray of column screen_half_width_ + k.
   void rebuildRayDeltas() {
-    // TODO(truvorskameikin): Build rays only for the half of the screen to save
-    // some memory.
+    screen_half_width_ = (int)(screen_width_ / 2.0f);
 
-    int screen_half_width = (int)(screen_width_ / 2.0f);
+    half_rays_.resize(screen_half_width_ + 1);
+    for (int k = 0; k <= screen_half_width_; ++k) {
+      float x = ((float)k / (float)screen_half_width_) *
+                horizontal_half_fov_tan_inv_;
+      half_rays_[k] = Math::Vector2d(x, 1.0f).GetNormalized();
+    }
+    rebuildProjectionFactors();
+  }
 
-    rays_.resize((int)screen_width_);
-    ray_lengths_inv_.resize((int)screen_width_);
+  // aspect_ratio / (tan_inv * dy) per column, dy of the normalized ray. Full
+  // width so ProjectColumns reads it with aligned vector loads.
+  void rebuildProjectionFactors() {
+    projection_factors_.resize((int)screen_width_);
     for (int i = 0; i < (int)screen_width_; ++i) {
-      float x = ((float)(i - screen_half_width) / (float)screen_half_width) *
-                horizontal_half_fov_tan_inv_;
-      Math::Vector2d v = Math::Vector2d(x, 1.0f);
+      projection_factors_[i] =
+          aspect_ratio_ / (horizontal_half_fov_tan_inv_ * getRay(i).y);
+    }
+  }
 
-      ray_lengths_inv_[i] = 1.0f / v.GetLength();
-      rays_[i] = Math::Vector2d(x, 1.0f).GetNormalized();
+  Math::Vector2d getRay(int ray_index) const {
+    int k = ray_index - screen_half_width_;
+    if (k < 0) {
+      const Math::Vector2d& ray = half_rays_[-k];
+      return Math::Vector2d(-ray.x, ray.y);
     }
+    return half_rays_[k];
+  }
+
+  float getScreenX(int ray_index) const {
+    return (float)(ray_index - screen_half_width_) /
+           (float)screen_half_width_;
   }
 
   float screen_width_{400};
@@ -94,8 +208,9 @@ class RayCastingProjection {
   float aspect_ratio_{400.0f / 240.0f};
   float horizontal_half_fov_deg_{45.0f};
   float horizontal_half_fov_tan_inv_{1.0f / tanf(Math::DegToRad(45.0f))};
-  std::vector<Math::Vector2d> rays_;
-  std::vector<float> ray_lengths_inv_;
+  int screen_half_width_{200};
+  std::vector<Math::Vector2d> half_rays_;
+  Memory::AlignedVector<float> projection_factors_;
   Math::Point2d camera_origin_;
   float camera_z_{0.0f};
   Math::Vector2d camera_direction_norm_;
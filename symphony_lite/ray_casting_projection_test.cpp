@@ -77,3 +77,53 @@ TEST(RayCastingProjection, Project_OnLine) {
   ASSERT_TRUE(AreOnLine(intersection_left_p, intersection_center_p,
                         intersection_right_p, 0.000001f));
 }
+
+TEST(RayCastingProjection, BakedRayTable) {
+  static constexpr RayTable<400> kRays = MakeRayTable<400>(90.0f);
+
+  RayCastingProjection computed(400, 240, /* horizontal_fov_deg= */ 90.0f);
+  RayCastingProjection baked;
+  baked.SetViewport(kRays, 240);
+
+  computed.SetCamera(Point2d(1.0f, 2.0f), 6.0f, Vector2d(0.0f, 1.0f));
+  baked.SetCamera(Point2d(1.0f, 2.0f), 6.0f, Vector2d(0.0f, 1.0f));
+  for (int i = 0; i < 400; ++i) {
+    Point2d expected = computed.Project(i, 10.0f, 0.0f);
+    Point2d result = baked.Project(i, 10.0f, 0.0f);
+    ASSERT_NEAR(expected.x, result.x, 1e-5f);
+    ASSERT_NEAR(expected.y, result.y, 1e-5f);
+
+    Vector2d expected_ray = computed.GetRayWorld(i);
+    Vector2d ray = baked.GetRayWorld(i);
+    ASSERT_NEAR(expected_ray.x, ray.x, 1e-5f);
+    ASSERT_NEAR(expected_ray.y, ray.y, 1e-5f);
+  }
+}
+
+TEST(RayCastingProjection, ProjectColumns) {
+  for (int screen_width : {400, 67}) {
+    RayCastingProjection proj(screen_width, 240,
+                              /* horizontal_fov_deg= */ 75.0f);
+    proj.SetCamera(Point2d(1.0f, 2.0f), 6.0f,
+                   Vector2d(0.6f, 0.8f).GetNormalized());
+
+    std::vector<float> distances;
+    for (int i = 0; i < screen_width; ++i) {
+      distances.push_back(3.0f + (float)(i % 17));
+    }
+    std::vector<Point2d> result(screen_width);
+    proj.ProjectColumns(distances, /* p_z= */ 1.0f, result);
+
+    for (int i = 0; i < screen_width; ++i) {
+      // The same point projected through its world position.
+      Point2d p = Point2d(1.0f, 2.0f) + proj.GetRayWorld(i) * distances[i];
+      Point2d expected = proj.Project(p, /* p_z= */ 1.0f);
+      ASSERT_NEAR(expected.x, result[i].x, 1e-4f);
+      ASSERT_NEAR(expected.y, result[i].y, 1e-4f);
+
+      Point2d single = proj.Project(i, distances[i], /* p_z= */ 1.0f);
+      ASSERT_NEAR(single.x, result[i].x, 1e-5f);
+      ASSERT_NEAR(single.y, result[i].y, 1e-5f);
+    }
+  }
+}
@@ -0,0 +1,589 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "distance_shading.hpp"
+#include "point2d.hpp"
+#include "ray_casting_projection.hpp"
+#include "thread_pool.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Visibility {
+// Column major image: pixels of a column are contiguous, so the vertical
+// spans the renderer draws are sequential writes. Used for the frame buffer
+// and for textures.
+struct Image {
+  Image() {}
+
+  Image(int new_width, int new_height) { Resize(new_width, new_height); }
+
+  void Resize(int new_width, int new_height) {
+    width = new_width;
+    height = new_height;
+    pixels.assign((size_t)width * height, 0);
+  }
+
+  uint32_t Get(int x, int y) const { return pixels[(size_t)x * height + y]; }
+
+  void Set(int x, int y, uint32_t color) {
+    pixels[(size_t)x * height + y] = color;
+  }
+
+  uint32_t* GetColumn(int x) { return pixels.data() + (size_t)x * height; }
+
+  const uint32_t* GetColumn(int x) const {
+    return pixels.data() + (size_t)x * height;
+  }
+
+  int width{0};
+  int height{0};
+  std::vector<uint32_t> pixels;
+};
+
+// Grid of unit sized tiles. Zero is empty space, wall tile t uses texture
+// t - 1.
+struct TileMap {
+  TileMap() {}
+
+  TileMap(int new_width, int new_height)
+      : width(new_width),
+        height(new_height),
+        tiles((size_t)new_width * new_height, 0) {}
+
+  bool IsInside(int i, int j) const {
+    return i >= 0 && j >= 0 && i < width && j < height;
+  }
+
+  uint8_t Get(int i, int j) const { return tiles[(size_t)j * width + i]; }
+
+  void Set(int i, int j, uint8_t tile) { tiles[(size_t)j * width + i] = tile; }
+
+  int width{0};
+  int height{0};
+  std::vector<uint8_t> tiles;
+};
+
+struct RayCastingParameters {
+  float wall_height{1.0f};
+  /// Rays stop after this distance, also caps floor and ceiling distance.
+  float max_distance{64.0f};
+  /// Index in textures or -1 to fill with the color. Floor and ceiling
+  /// texture sizes must be powers of two.
+  int floor_texture{-1};
+  int ceiling_texture{-1};
+  uint32_t floor_color{0xff404040};
+  uint32_t ceiling_color{0xff202020};
+  /// Fog applied to walls, floor and ceiling, nullptr for none.
+  const DistanceShading* shading{nullptr};
+};
+
+// Wolfenstein style renderer: one ray per screen column walks the tile map
+// (DDA), the hit wall is drawn as a textured vertical span and the rest of
+// the column is floor and ceiling.
+class RayCastingRenderer {
+ public:
+  /// Walls closer than this are drawn at this depth. A camera on the
+  /// border of a wall tile hits it at depth 0.
+  static constexpr float kNearDepth = 0.001f;
+
+  /// \arg textures Wall tile t uses textures[t - 1].
+  /// \arg frame_buffer Must have the screen size of projection.
+  void Render(const RayCastingProjection& projection, const TileMap& map,
+              const std::vector<Image>& textures,
+              const RayCastingParameters& parameters, Image& frame_buffer) {
+    beginFrame(projection, parameters, frame_buffer.width,
+               frame_buffer.height);
+    renderColumns(projection, map, textures, parameters, 0,
+                  frame_buffer.width, frame_buffer);
+  }
+
+  /// Same as Render, but ranges of columns_per_task columns are rendered in
+  /// parallel on the pool. Tasks write disjoint frame buffer columns and
+  /// depth entries, so they need no synchronization.
+  void Render(const RayCastingProjection& projection, const TileMap& map,
+              const std::vector<Image>& textures,
+              const RayCastingParameters& parameters,
+              Threading::ThreadPool& pool, Image& frame_buffer,
+              int columns_per_task = 16) {
+    beginFrame(projection, parameters, frame_buffer.width,
+               frame_buffer.height);
+    pool.ParallelFor(0, frame_buffer.width, columns_per_task,
+                     [&](int x_begin, int x_end) {
+                       renderColumns(projection, map, textures, parameters,
+                                     x_begin, x_end, frame_buffer);
+                     });
+  }
+
+  /// Renders the two views of a stereo pair, eyes eye_distance apart around
+  /// the camera of projection. Rays are cast once from the center camera;
+  /// an eye column between two center columns that hit the same wall face
+  /// intersects that face directly. Only columns with no such face, seen by
+  /// one eye around corners or past the center view, cast their own ray.
+  /// GetDepthBuffer is the left eye afterwards, GetRightDepthBuffer the
+  /// right one.
+  void RenderStereo(const RayCastingProjection& projection,
+                    float eye_distance, const TileMap& map,
+                    const std::vector<Image>& textures,
+                    const RayCastingParameters& parameters,
+                    Image& left_frame_buffer, Image& right_frame_buffer) {
+    int screen_width = left_frame_buffer.width;
+    // Eyes share the camera direction and height, so the rows are the same.
+    beginFrame(projection, parameters, screen_width,
+               left_frame_buffer.height);
+    right_depth_buffer_.resize(screen_width);
+
+    const Math::Point2d& camera_origin = projection.GetCameraOrigin();
+    center_hits_.resize(screen_width);
+    center_points_.resize(screen_width);
+    center_has_hit_.resize(screen_width);
+    for (int x = 0; x < screen_width; ++x) {
+      Math::Vector2d ray = projection.GetRayWorld(x);
+      center_has_hit_[x] = castRay(map, camera_origin, ray,
+                                   parameters.max_distance, center_hits_[x]);
+      center_points_[x] = camera_origin + ray * center_hits_[x].distance;
+    }
+
+    Math::Vector2d eye_offset =
+        projection.GetCameraRight() * (eye_distance * 0.5f);
+    eye_projection_ = projection;
+    eye_projection_.SetCamera(camera_origin - eye_offset,
+                              projection.GetCameraZ(),
+                              projection.GetCameraDirection());
+    renderEye(eye_projection_, map, textures, parameters, depth_buffer_,
+              left_frame_buffer);
+    eye_projection_.SetCamera(camera_origin + eye_offset,
+                              projection.GetCameraZ(),
+                              projection.GetCameraDirection());
+    renderEye(eye_projection_, map, textures, parameters,
+              right_depth_buffer_, right_frame_buffer);
+  }
+
+  /// Distance along the camera direction to the wall of every column of the
+  /// last frame, infinity where no wall was hit. Use it to clip sprites.
+  const std::vector<float>& GetDepthBuffer() const { return depth_buffer_; }
+
+  /// Right eye depth buffer of the last RenderStereo.
+  const std::vector<float>& GetRightDepthBuffer() const {
+    return right_depth_buffer_;
+  }
+
+ private:
+  // Eye columns in RenderStereo.
+  enum EyeColumnState : uint8_t {
+    kUncovered,
+    // Wall found from the center hits.
+    kCovered,
+    // Near a depth discontinuity of the center view.
+    kUncertain,
+  };
+
+  struct WallHit {
+    /// Along the ray.
+    float distance;
+    /// Horizontal texture coordinate in [0, 1).
+    float u;
+    uint8_t tile;
+    /// Face the ray entered: the line x = face when crossed_x, y = face
+    /// otherwise, entered moving in the step direction along that axis.
+    bool crossed_x;
+    int8_t step;
+    int face;
+
+    bool IsSameFace(const WallHit& other) const {
+      return crossed_x == other.crossed_x && step == other.step &&
+             face == other.face;
+    }
+  };
+
+  void beginFrame(const RayCastingProjection& projection,
+                  const RayCastingParameters& parameters, int screen_width,
+                  int screen_height) {
+    depth_buffer_.resize(screen_width);
+
+    // Screen y of a point one unit above the camera and one unit ahead.
+    // Projected height scales with dz / depth from there.
+    Math::Point2d camera_origin = projection.GetCameraOrigin();
+    float camera_z = projection.GetCameraZ();
+    vertical_scale_ =
+        projection
+            .Project(camera_origin + projection.GetCameraDirection(),
+                     camera_z + 1.0f)
+            .y;
+
+    // Floor and ceiling distance only depend on the row.
+    row_depths_.resize(screen_height);
+    horizon_row_ = screen_height;
+    for (int y = 0; y < screen_height; ++y) {
+      float screen_y = rowToScreenY(y, screen_height);
+      float dz = 0.0f;
+      if (screen_y < 0.0f) {
+        dz = -camera_z;
+        horizon_row_ = std::min(horizon_row_, y);
+      } else {
+        dz = parameters.wall_height - camera_z;
+      }
+      float depth = parameters.max_distance;
+      if (screen_y != 0.0f) {
+        depth = std::min(dz * vertical_scale_ / screen_y, depth);
+      }
+      row_depths_[y] = depth;
+    }
+
+    if (parameters.shading != nullptr) {
+      row_levels_.resize(screen_height);
+      for (int y = 0; y < screen_height; ++y) {
+        row_levels_[y] = (uint8_t)parameters.shading->GetLevel(row_depths_[y]);
+      }
+    }
+  }
+
+  void renderColumns(const RayCastingProjection& projection,
+                     const TileMap& map, const std::vector<Image>& textures,
+                     const RayCastingParameters& parameters, int x_begin,
+                     int x_end, Image& frame_buffer) {
+    for (int x = x_begin; x < x_end; ++x) {
+      renderColumn(projection, map, textures, parameters, x, frame_buffer);
+    }
+  }
+
+  void renderColumn(const RayCastingProjection& projection,
+                    const TileMap& map, const std::vector<Image>& textures,
+                    const RayCastingParameters& parameters, int x,
+                    Image& frame_buffer) {
+    WallHit hit;
+    bool has_hit = castRay(map, projection.GetCameraOrigin(),
+                           projection.GetRayWorld(x),
+                           parameters.max_distance, hit);
+    drawColumn(projection, textures, parameters, x, has_hit ? &hit : nullptr,
+               depth_buffer_[x], frame_buffer);
+  }
+
+  // Moves the center hits to the eye: every pair of neighbouring center
+  // columns on one face covers the eye columns between their projections,
+  // nearest face wins. Eye columns between a pair across a depth
+  // discontinuity may see what the center camera doesn't, in front of or
+  // behind the edge, so they are cast from the eye like uncovered ones.
+  void renderEye(const RayCastingProjection& eye_projection,
+                 const TileMap& map, const std::vector<Image>& textures,
+                 const RayCastingParameters& parameters,
+                 std::vector<float>& depth_buffer, Image& frame_buffer) {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+    int screen_width = frame_buffer.width;
+    const Math::Point2d& eye_origin = eye_projection.GetCameraOrigin();
+    const Math::Vector2d& direction = eye_projection.GetCameraDirection();
+
+    eye_hits_.resize(screen_width);
+    eye_columns_.resize(screen_width);
+    eye_column_states_.assign(screen_width, kUncovered);
+    std::fill(depth_buffer.begin(), depth_buffer.end(), kInfinity);
+    for (int c = 0; c < screen_width; ++c) {
+      // Points at infinity project to the same column for both cameras.
+      eye_columns_[c] = center_has_hit_[c]
+                            ? getEyeColumn(eye_projection, center_points_[c])
+                            : (float)c;
+    }
+
+    for (int c = 0; c + 1 < screen_width; ++c) {
+      float low = std::min(eye_columns_[c], eye_columns_[c + 1]);
+      float high = std::max(eye_columns_[c], eye_columns_[c + 1]);
+      int x_begin = (int)std::clamp(ceilf(low), 0.0f, (float)screen_width);
+      int x_end =
+          (int)std::clamp(floorf(high) + 1.0f, 0.0f, (float)screen_width);
+
+      if (!center_has_hit_[c] || !center_has_hit_[c + 1] ||
+          !center_hits_[c].IsSameFace(center_hits_[c + 1])) {
+        x_begin = std::max(x_begin - 1, 0);
+        x_end = std::min(x_end + 1, screen_width);
+        for (int x = x_begin; x < x_end; ++x) {
+          eye_column_states_[x] = kUncertain;
+        }
+        continue;
+      }
+
+      for (int x = x_begin; x < x_end; ++x) {
+        if (eye_column_states_[x] == kUncertain) {
+          continue;
+        }
+        Math::Vector2d ray = eye_projection.GetRayWorld(x);
+        WallHit hit;
+        if (intersectFace(map, eye_origin, ray, center_hits_[c],
+                          parameters.max_distance, hit)) {
+          float depth = hit.distance * (ray * direction);
+          if (depth < depth_buffer[x]) {
+            depth_buffer[x] = depth;
+            eye_hits_[x] = hit;
+            eye_column_states_[x] = kCovered;
+          }
+        }
+      }
+    }
+
+    for (int x = 0; x < screen_width; ++x) {
+      const WallHit* hit = nullptr;
+      if (eye_column_states_[x] == kCovered) {
+        hit = &eye_hits_[x];
+      } else if (castRay(map, eye_origin, eye_projection.GetRayWorld(x),
+                         parameters.max_distance, eye_hits_[x])) {
+        hit = &eye_hits_[x];
+      }
+      drawColumn(eye_projection, textures, parameters, x, hit,
+                 depth_buffer[x], frame_buffer);
+    }
+  }
+
+  // Screen column of a world point, far off screen on its side when it is
+  // behind the camera plane.
+  static float getEyeColumn(const RayCastingProjection& eye_projection,
+                            const Math::Point2d& p) {
+    float screen_width = (float)eye_projection.GetScreenWidth();
+    float half_width = (float)(eye_projection.GetScreenWidth() / 2);
+    Math::Vector2d to_p = p - eye_projection.GetCameraOrigin();
+    if (to_p * eye_projection.GetCameraDirection() <= 0.0f) {
+      bool right = to_p * eye_projection.GetCameraRight() > 0.0f;
+      return right ? 2.0f * screen_width : -screen_width;
+    }
+    return eye_projection.Project(p, eye_projection.GetCameraZ()).x *
+               half_width +
+           half_width;
+  }
+
+  /// \arg hit Wall seen in the column or nullptr.
+  void drawColumn(const RayCastingProjection& projection,
+                  const std::vector<Image>& textures,
+                  const RayCastingParameters& parameters, int x,
+                  const WallHit* hit, float& depth_out,
+                  Image& frame_buffer) const {
+    const Math::Point2d& camera_origin = projection.GetCameraOrigin();
+    float camera_z = projection.GetCameraZ();
+    Math::Vector2d ray = projection.GetRayWorld(x);
+    float ray_cos = ray * projection.GetCameraDirection();
+
+    int screen_height = frame_buffer.height;
+    uint32_t* column = frame_buffer.GetColumn(x);
+
+    int wall_begin = horizon_row_;
+    int wall_end = horizon_row_;
+    depth_out = std::numeric_limits<float>::infinity();
+
+    if (hit != nullptr) {
+      float depth = std::max(hit->distance * ray_cos, kNearDepth);
+      depth_out = depth;
+
+      float top = screenYToRow(
+          (parameters.wall_height - camera_z) * vertical_scale_ / depth,
+          screen_height);
+      float bottom = screenYToRow(-camera_z * vertical_scale_ / depth,
+                                  screen_height);
+      // Clamped as floats, walls right in front of the camera project far
+      // outside the int range.
+      wall_begin = (int)std::clamp(ceilf(top - 0.5f), 0.0f,
+                                   (float)screen_height);
+      wall_end = (int)std::clamp(ceilf(bottom - 0.5f), 0.0f,
+                                 (float)screen_height);
+
+      const Image& texture = textures[hit->tile - 1];
+      int texture_x =
+          std::min((int)(hit->u * texture.width), texture.width - 1);
+      const uint32_t* texture_column = texture.GetColumn(texture_x);
+      float v_step = (float)texture.height / (bottom - top);
+      float v = ((float)wall_begin + 0.5f - top) * v_step;
+      int max_v = texture.height - 1;
+      for (int y = wall_begin; y < wall_end; ++y) {
+        column[y] = texture_column[std::min((int)v, max_v)];
+        v += v_step;
+      }
+      if (parameters.shading != nullptr) {
+        parameters.shading->ShadeSpan(column + wall_begin,
+                                      wall_end - wall_begin,
+                                      parameters.shading->GetLevel(depth));
+      }
+    }
+
+    // Point on the floor or ceiling seen through a row is this far along
+    // the ray per unit of row depth.
+    Math::Vector2d ray_per_depth = ray * (1.0f / ray_cos);
+    fillPlane(camera_origin, ray_per_depth, textures,
+              parameters.ceiling_texture, parameters.ceiling_color, 0,
+              wall_begin, column);
+    fillPlane(camera_origin, ray_per_depth, textures,
+              parameters.floor_texture, parameters.floor_color, wall_end,
+              screen_height, column);
+    if (parameters.shading != nullptr) {
+      parameters.shading->ShadeSpan(column, wall_begin, row_levels_.data());
+      parameters.shading->ShadeSpan(column + wall_end,
+                                    screen_height - wall_end,
+                                    row_levels_.data() + wall_end);
+    }
+  }
+
+  void fillPlane(const Math::Point2d& camera_origin,
+                 const Math::Vector2d& ray_per_depth,
+                 const std::vector<Image>& textures, int texture_index,
+                 uint32_t color, int y_begin, int y_end,
+                 uint32_t* column) const {
+    if (texture_index < 0) {
+      std::fill(column + y_begin, column + y_end, color);
+      return;
+    }
+
+    const Image& texture = textures[texture_index];
+    int mask_x = texture.width - 1;
+    int mask_y = texture.height - 1;
+    for (int y = y_begin; y < y_end; ++y) {
+      Math::Point2d p = camera_origin + ray_per_depth * row_depths_[y];
+      int texture_x = (int)(p.x * (float)texture.width) & mask_x;
+      int texture_y = (int)(p.y * (float)texture.height) & mask_y;
+      column[y] = texture.Get(texture_x, texture_y);
+    }
+  }
+
+  // Steps from tile to tile along the ray (Amanatides-Woo). The tile the ray
+  // starts in is never reported.
+  static bool castRay(const TileMap& map, const Math::Point2d& ray_start,
+                      const Math::Vector2d& ray_dir_norm, float max_distance,
+                      WallHit& hit_out) {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+
+    int i = (int)floorf(ray_start.x);
+    int j = (int)floorf(ray_start.y);
+
+    int step_i = ray_dir_norm.x < 0.0f ? -1 : 1;
+    float delta_x =
+        ray_dir_norm.x == 0.0f ? kInfinity : fabsf(1.0f / ray_dir_norm.x);
+    float side_x = ray_dir_norm.x < 0.0f
+                       ? (ray_start.x - (float)i) * delta_x
+                       : ((float)(i + 1) - ray_start.x) * delta_x;
+
+    int step_j = ray_dir_norm.y < 0.0f ? -1 : 1;
+    float delta_y =
+        ray_dir_norm.y == 0.0f ? kInfinity : fabsf(1.0f / ray_dir_norm.y);
+    float side_y = ray_dir_norm.y < 0.0f
+                       ? (ray_start.y - (float)j) * delta_y
+                       : ((float)(j + 1) - ray_start.y) * delta_y;
+
+    while (true) {
+      bool crossed_x = side_x < side_y;
+      float distance = 0.0f;
+      if (crossed_x) {
+        distance = side_x;
+        side_x += delta_x;
+        i += step_i;
+      } else {
+        distance = side_y;
+        side_y += delta_y;
+        j += step_j;
+      }
+
+      if (distance > max_distance || !map.IsInside(i, j)) {
+        return false;
+      }
+
+      uint8_t tile = map.Get(i, j);
+      if (tile == 0) {
+        continue;
+      }
+
+      Math::Point2d hit_point = ray_start + ray_dir_norm * distance;
+      hit_out.distance = distance;
+      hit_out.u = getWallU(crossed_x, hit_point, ray_dir_norm);
+      hit_out.tile = tile;
+      hit_out.crossed_x = crossed_x;
+      if (crossed_x) {
+        hit_out.step = (int8_t)step_i;
+        hit_out.face = step_i > 0 ? i : i + 1;
+      } else {
+        hit_out.step = (int8_t)step_j;
+        hit_out.face = step_j > 0 ? j : j + 1;
+      }
+      return true;
+    }
+  }
+
+  // Hit of the ray with the face of another hit, false when it misses the
+  // face or the tile there is empty.
+  static bool intersectFace(const TileMap& map, const Math::Point2d& ray_start,
+                            const Math::Vector2d& ray_dir_norm,
+                            const WallHit& face_hit, float max_distance,
+                            WallHit& hit_out) {
+    float start = face_hit.crossed_x ? ray_start.x : ray_start.y;
+    float dir = face_hit.crossed_x ? ray_dir_norm.x : ray_dir_norm.y;
+    if (dir * (float)face_hit.step <= 0.0f) {
+      return false;
+    }
+
+    float distance = ((float)face_hit.face - start) / dir;
+    if (distance <= 0.0f || distance > max_distance) {
+      return false;
+    }
+
+    Math::Point2d hit_point = ray_start + ray_dir_norm * distance;
+    int tile_across = face_hit.step > 0 ? face_hit.face : face_hit.face - 1;
+    int tile_along =
+        (int)floorf(face_hit.crossed_x ? hit_point.y : hit_point.x);
+    int i = face_hit.crossed_x ? tile_across : tile_along;
+    int j = face_hit.crossed_x ? tile_along : tile_across;
+    if (!map.IsInside(i, j) || map.Get(i, j) == 0) {
+      return false;
+    }
+
+    hit_out = face_hit;
+    hit_out.distance = distance;
+    hit_out.u = getWallU(face_hit.crossed_x, hit_point, ray_dir_norm);
+    hit_out.tile = map.Get(i, j);
+    return true;
+  }
+
+  // Texture runs left to right when looking at the wall.
+  static float getWallU(bool crossed_x, const Math::Point2d& hit_point,
+                        const Math::Vector2d& ray_dir_norm) {
+    float u = 0.0f;
+    if (crossed_x) {
+      u = hit_point.y - floorf(hit_point.y);
+      if (ray_dir_norm.x < 0.0f) {
+        u = 1.0f - u;
+      }
+    } else {
+      u = hit_point.x - floorf(hit_point.x);
+      if (ray_dir_norm.y > 0.0f) {
+        u = 1.0f - u;
+      }
+    }
+    return std::min(u, 0.99999f);
+  }
+
+  static float rowToScreenY(int y, int screen_height) {
+    return 1.0f - 2.0f * ((float)y + 0.5f) / (float)screen_height;
+  }
+
+  static float screenYToRow(float screen_y, int screen_height) {
+    return (1.0f - screen_y) * 0.5f * (float)screen_height;
+  }
+
+  std::vector<float> depth_buffer_;
+  std::vector<float> right_depth_buffer_;
+  std::vector<float> row_depths_;
+  // Shading level of row_depths_.
+  std::vector<uint8_t> row_levels_;
+  float vertical_scale_{1.0f};
+  // First row below the horizon.
+  int horizon_row_{0};
+
+  // Stereo scratch, kept between frames to avoid allocations.
+  std::vector<WallHit> center_hits_;
+  std::vector<Math::Point2d> center_points_;
+  std::vector<uint8_t> center_has_hit_;
+  RayCastingProjection eye_projection_;
+  std::vector<WallHit> eye_hits_;
+  // Center hits projected to the eye screen, in columns.
+  std::vector<float> eye_columns_;
+  std::vector<uint8_t> eye_column_states_;
+};
+}  // namespace Visibility
+}  // namespace Symphony
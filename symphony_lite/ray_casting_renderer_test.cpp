@@ -0,0 +1,217 @@
+#include "ray_casting_renderer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+using namespace Symphony::Math;
+using namespace Symphony::Visibility;
+
+namespace {
+const uint32_t kWallColor = 0xffff0000;
+const uint32_t kOtherWallColor = 0xff00ff00;
+
+// Room with walls on the border.
+TileMap MakeRoom(int size) {
+  TileMap map(size, size);
+  for (int i = 0; i < size; ++i) {
+    map.Set(i, 0, 1);
+    map.Set(i, size - 1, 1);
+    map.Set(0, i, 1);
+    map.Set(size - 1, i, 1);
+  }
+  return map;
+}
+
+std::vector<Image> MakeTextures() {
+  Image wall(4, 4);
+  std::fill(wall.pixels.begin(), wall.pixels.end(), kWallColor);
+  Image other_wall(4, 4);
+  std::fill(other_wall.pixels.begin(), other_wall.pixels.end(),
+            kOtherWallColor);
+  Image checker(2, 2);
+  checker.Set(0, 0, 0xff000001);
+  checker.Set(1, 1, 0xff000001);
+  checker.Set(0, 1, 0xff000002);
+  checker.Set(1, 0, 0xff000002);
+  return {wall, other_wall, checker};
+}
+}  // namespace
+
+TEST(RayCastingRenderer, WallsFloorCeiling) {
+  TileMap map = MakeRoom(8);
+  std::vector<Image> textures = MakeTextures();
+
+  RayCastingProjection projection(64, 48, /* horizontal_fov_deg= */ 90.0f);
+  projection.SetCamera(Point2d(4.5f, 4.5f), 0.5f, Vector2d(0.0f, 1.0f));
+
+  RayCastingParameters parameters;
+  Image frame_buffer(64, 48);
+  RayCastingRenderer renderer;
+  renderer.Render(projection, map, textures, parameters, frame_buffer);
+
+  const std::vector<float>& depth = renderer.GetDepthBuffer();
+  ASSERT_EQ(64, (int)depth.size());
+  // The wall is flat, so the depth is the same in every column.
+  for (int x = 0; x < 64; ++x) {
+    ASSERT_NEAR(2.5f, depth[x], 0.001f);
+  }
+
+  // Wall is 1 high, seen from the middle of its height 2.5 away: it spans
+  // 1 / 2.5 of the vertical screen size (scaled by aspect ratio).
+  for (int x = 0; x < 64; ++x) {
+    ASSERT_EQ(kWallColor, frame_buffer.Get(x, 24));
+    ASSERT_EQ(parameters.ceiling_color, frame_buffer.Get(x, 0));
+    ASSERT_EQ(parameters.floor_color, frame_buffer.Get(x, 47));
+  }
+  int wall_rows = 0;
+  for (int y = 0; y < 48; ++y) {
+    wall_rows += frame_buffer.Get(32, y) == kWallColor ? 1 : 0;
+  }
+  ASSERT_NEAR(48.0f * (4.0f / 3.0f) / 2.5f / 2.0f, (float)wall_rows, 1.0f);
+}
+
+TEST(RayCastingRenderer, CameraOnWallBorder) {
+  TileMap map = MakeRoom(8);
+  std::vector<Image> textures = MakeTextures();
+
+  // Right on the border of the x = 0 wall tiles, facing them.
+  RayCastingProjection projection(64, 48, /* horizontal_fov_deg= */ 90.0f);
+  projection.SetCamera(Point2d(1.0f, 4.5f), 0.5f, Vector2d(-1.0f, 0.0f));
+
+  RayCastingParameters parameters;
+  Image frame_buffer(64, 48);
+  RayCastingRenderer renderer;
+  renderer.Render(projection, map, textures, parameters, frame_buffer);
+
+  for (int x = 0; x < 64; ++x) {
+    ASSERT_EQ(RayCastingRenderer::kNearDepth, renderer.GetDepthBuffer()[x]);
+    for (int y = 0; y < 48; ++y) {
+      ASSERT_EQ(kWallColor, frame_buffer.Get(x, y));
+    }
+  }
+}
+
+TEST(RayCastingRenderer, ClosestWallAndTexturedFloor) {
+  TileMap map = MakeRoom(8);
+  map.Set(4, 6, 2);
+  std::vector<Image> textures = MakeTextures();
+
+  RayCastingProjection projection(64, 48, /* horizontal_fov_deg= */ 90.0f);
+  projection.SetCamera(Point2d(4.5f, 4.5f), 0.5f, Vector2d(0.0f, 1.0f));
+
+  RayCastingParameters parameters;
+  parameters.floor_texture = 2;
+  parameters.ceiling_texture = 2;
+  Image frame_buffer(64, 48);
+  RayCastingRenderer renderer;
+  renderer.Render(projection, map, textures, parameters, frame_buffer);
+
+  ASSERT_NEAR(1.5f, renderer.GetDepthBuffer()[32], 0.001f);
+  ASSERT_EQ(kOtherWallColor, frame_buffer.Get(32, 24));
+  ASSERT_EQ(kWallColor, frame_buffer.Get(0, 24));
+
+  for (int y : {0, 47}) {
+    uint32_t color = frame_buffer.Get(32, y);
+    ASSERT_TRUE(color == 0xff000001 || color == 0xff000002);
+  }
+}
+
+TEST(RayCastingRenderer, NoWall) {
+  TileMap map(8, 8);
+  std::vector<Image> textures = MakeTextures();
+
+  RayCastingProjection projection(64, 48, /* horizontal_fov_deg= */ 90.0f);
+  projection.SetCamera(Point2d(4.5f, 4.5f), 0.5f, Vector2d(1.0f, 0.0f));
+
+  RayCastingParameters parameters;
+  Image frame_buffer(64, 48);
+  RayCastingRenderer renderer;
+  renderer.Render(projection, map, textures, parameters, frame_buffer);
+
+  ASSERT_EQ(std::numeric_limits<float>::infinity(),
+            renderer.GetDepthBuffer()[10]);
+  for (int y = 0; y < 48; ++y) {
+    ASSERT_EQ(y < 24 ? parameters.ceiling_color : parameters.floor_color,
+              frame_buffer.Get(10, y));
+  }
+}
+
+TEST(RayCastingRenderer, ParallelMatchesSerial) {
+  TileMap map = MakeRoom(16);
+  map.Set(5, 9, 2);
+  map.Set(11, 4, 2);
+  std::vector<Image> textures = MakeTextures();
+
+  RayCastingProjection projection(120, 80, /* horizontal_fov_deg= */ 75.0f);
+  projection.SetCamera(Point2d(7.3f, 6.1f), 0.5f,
+                       Vector2d(0.3f, 1.0f).GetNormalized());
+
+  RayCastingParameters parameters;
+  parameters.floor_texture = 2;
+  Image serial(120, 80);
+  RayCastingRenderer serial_renderer;
+  serial_renderer.Render(projection, map, textures, parameters, serial);
+
+  Symphony::Threading::ThreadPool pool(3);
+  Image parallel(120, 80);
+  RayCastingRenderer parallel_renderer;
+  parallel_renderer.Render(projection, map, textures, parameters, pool,
+                           parallel, /* columns_per_task= */ 7);
+
+  ASSERT_EQ(serial.pixels, parallel.pixels);
+  ASSERT_EQ(serial_renderer.GetDepthBuffer(),
+            parallel_renderer.GetDepthBuffer());
+}
+
+TEST(RayCastingRenderer, StereoMatchesEyeCameras) {
+  TileMap map = MakeRoom(16);
+  // Pillars in front of the wall, so each eye sees wall the center camera
+  // doesn't.
+  map.Set(6, 9, 2);
+  map.Set(9, 10, 2);
+  map.Set(11, 4, 2);
+  std::vector<Image> textures = MakeTextures();
+
+  RayCastingProjection projection(120, 80, /* horizontal_fov_deg= */ 90.0f);
+  Point2d origin(7.3f, 6.1f);
+  Vector2d direction = Vector2d(0.3f, 1.0f).GetNormalized();
+  projection.SetCamera(origin, 0.5f, direction);
+
+  RayCastingParameters parameters;
+  parameters.floor_texture = 2;
+  const float kEyeDistance = 0.4f;
+  Image left(120, 80);
+  Image right(120, 80);
+  RayCastingRenderer stereo_renderer;
+  stereo_renderer.RenderStereo(projection, kEyeDistance, map, textures,
+                               parameters, left, right);
+
+  Vector2d eye_offset = projection.GetCameraRight() * (kEyeDistance * 0.5f);
+  for (int eye = 0; eye < 2; ++eye) {
+    RayCastingProjection eye_projection(120, 80, 90.0f);
+    eye_projection.SetCamera(
+        eye == 0 ? origin - eye_offset : origin + eye_offset, 0.5f,
+        direction);
+    Image expected(120, 80);
+    RayCastingRenderer mono_renderer;
+    mono_renderer.Render(eye_projection, map, textures, parameters,
+                         expected);
+
+    const Image& actual = eye == 0 ? left : right;
+    const std::vector<float>& depth =
+        eye == 0 ? stereo_renderer.GetDepthBuffer()
+                 : stereo_renderer.GetRightDepthBuffer();
+    for (int x = 0; x < 120; ++x) {
+      ASSERT_NEAR(mono_renderer.GetDepthBuffer()[x], depth[x], 1e-4f)
+          << "eye " << eye << " column " << x;
+    }
+    // Texture coordinates may round differently right at texel borders.
+    int num_different = 0;
+    for (size_t i = 0; i < expected.pixels.size(); ++i) {
+      num_different += expected.pixels[i] != actual.pixels[i];
+    }
+    EXPECT_LT(num_different, (int)expected.pixels.size() / 200) << eye;
+  }
+}
@@ -5,47 +5,55 @@
 
 namespace Symphony {
 namespace Math {
-class Segment2d {
+/// \arg Scalar float or Fixed.
+template <typename Scalar>
+class BasicSegment2d {
  public:
-  Segment2d() {}
+  constexpr BasicSegment2d() {}
 
-  Segment2d(const Point2d& new_p0, const Point2d new_p1)
+  constexpr BasicSegment2d(const BasicPoint2d<Scalar>& new_p0,
+                           const BasicPoint2d<Scalar> new_p1)
       : p0(new_p0), p1(new_p1) {}
 
-  bool Intersect(const Segment2d& seg1, float eps, Point2d& intersection_out) {
-    float this_seg_fraction = 0.0f;
-    float seg1_fraction = 0.0f;
+  bool Intersect(const BasicSegment2d& seg1, Scalar eps,
+                 BasicPoint2d<Scalar>& intersection_out) {
+    Scalar this_seg_fraction = 0;
+    Scalar seg1_fraction = 0;
     return Intersect(seg1, eps, intersection_out, this_seg_fraction,
                      seg1_fraction);
   }
 
-  bool Intersect(const Segment2d& seg1, float eps, Point2d& intersection_out,
-                 float& this_seg_fraction, float& seg1_fraction) {
-    Vector2d v1 = p1 - p0;
-    Vector2d v2 = seg1.p1 - seg1.p0;
+  bool Intersect(const BasicSegment2d& seg1, Scalar eps,
+                 BasicPoint2d<Scalar>& intersection_out,
+                 Scalar& this_seg_fraction, Scalar& seg1_fraction) {
+    BasicVector2d<Scalar> v1 = p1 - p0;
+    BasicVector2d<Scalar> v2 = seg1.p1 - seg1.p0;
 
-    float D = v1.x * v2.y - v1.y * v2.x;
-    if (fabsf(D) < eps) {
+    // Wide, so long Fixed segments don't overflow.
+    auto D = v1.CrossWide(v2);
+    auto eps_wide = ToWide(eps);
+    if (D < eps_wide && -D < eps_wide) {
       return false;
     }
 
-    Vector2d a = seg1.p0 - p0;
+    BasicVector2d<Scalar> a = seg1.p0 - p0;
 
-    float t = (a.x * v2.y - a.y * v2.x) / D;
-    if (t < 0.0f) {
-      return false;
+    auto t_numerator = a.CrossWide(v2);
+    auto u_numerator = a.CrossWide(v1);
+    if (D < 0) {
+      D = -D;
+      t_numerator = -t_numerator;
+      u_numerator = -u_numerator;
     }
-    if (t > 1.0f) {
+    // t and u in [0, 1] checked before dividing.
+    if (t_numerator < 0 || t_numerator > D) {
       return false;
     }
-
-    float u = (a.x * v1.y - a.y * v1.x) / D;
-    if (u < 0.0f) {
-      return false;
-    }
-    if (u > 1.0f) {
+    if (u_numerator < 0 || u_numerator > D) {
       return false;
     }
+    Scalar t = DivWide(t_numerator, D);
+    Scalar u = DivWide(u_numerator, D);
 
     intersection_out.x = p0.x + v1.x * t;
     intersection_out.y = p0.y + v1.y * t;
@@ -55,8 +63,11 @@ class Segment2d {
     return true;
   }
 
-  Point2d p0;
-  Point2d p1;
+  BasicPoint2d<Scalar> p0;
+  BasicPoint2d<Scalar> p1;
 };
+
+using Segment2d = BasicSegment2d<float>;
+using FixedSegment2d = BasicSegment2d<Fixed>;
 }  // namespace Math
 }  // namespace Symphony
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <math.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Symphony {
+namespace Simd {
+// Thin wrapper over the widest float vector the target has, so bulk kernels
+// are written once. Targets without SSE2 or AVX (like PSP) get one lane.
+#if defined(__AVX__)
+struct Float {
+  static const int kLanes = 8;
+
+  static Float Load(const float* p) { return {_mm256_loadu_ps(p)}; }
+  static Float LoadAligned(const float* p) { return {_mm256_load_ps(p)}; }
+  static Float Set(float value) { return {_mm256_set1_ps(value)}; }
+
+  void Store(float* p) const { _mm256_storeu_ps(p, v); }
+  void StoreAligned(float* p) const { _mm256_store_ps(p, v); }
+
+  __m256 v;
+};
+
+inline Float operator+(Float a, Float b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Float operator/(Float a, Float b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline Float Min(Float a, Float b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline Float Max(Float a, Float b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline Float Sqrt(Float a) { return {_mm256_sqrt_ps(a.v)}; }
+inline Float Round(Float a) {
+  return {_mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+/// About 12 bits of precision.
+inline Float RsqrtEstimate(Float a) { return {_mm256_rsqrt_ps(a.v)}; }
+/// About 12 bits of precision.
+inline Float RcpEstimate(Float a) { return {_mm256_rcp_ps(a.v)}; }
+#elif defined(__SSE2__)
+struct Float {
+  static const int kLanes = 4;
+
+  static Float Load(const float* p) { return {_mm_loadu_ps(p)}; }
+  static Float LoadAligned(const float* p) { return {_mm_load_ps(p)}; }
+  static Float Set(float value) { return {_mm_set1_ps(value)}; }
+
+  void Store(float* p) const { _mm_storeu_ps(p, v); }
+  void StoreAligned(float* p) const { _mm_store_ps(p, v); }
+
+  __m128 v;
+};
+
+inline Float operator+(Float a, Float b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Float operator/(Float a, Float b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Float Min(Float a, Float b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Float Max(Float a, Float b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Float Sqrt(Float a) { return {_mm_sqrt_ps(a.v)}; }
+/// Goes through int32, values must fit.
+inline Float Round(Float a) { return {_mm_cvtepi32_ps(_mm_cvtps_epi32(a.v))}; }
+inline Float RsqrtEstimate(Float a) { return {_mm_rsqrt_ps(a.v)}; }
+inline Float RcpEstimate(Float a) { return {_mm_rcp_ps(a.v)}; }
+#else
+struct Float {
+  static const int kLanes = 1;
+
+  static Float Load(const float* p) { return {*p}; }
+  static Float LoadAligned(const float* p) { return {*p}; }
+  static Float Set(float value) { return {value}; }
+
+  void Store(float* p) const { *p = v; }
+  void StoreAligned(float* p) const { *p = v; }
+
+  float v;
+};
+
+inline Float operator+(Float a, Float b) { return {a.v + b.v}; }
+inline Float operator-(Float a, Float b) { return {a.v - b.v}; }
+inline Float operator*(Float a, Float b) { return {a.v * b.v}; }
+inline Float operator/(Float a, Float b) { return {a.v / b.v}; }
+inline Float Min(Float a, Float b) { return {a.v < b.v ? a.v : b.v}; }
+inline Float Max(Float a, Float b) { return {a.v > b.v ? a.v : b.v}; }
+inline Float Sqrt(Float a) { return {sqrtf(a.v)}; }
+inline Float Round(Float a) { return {rintf(a.v)}; }
+inline Float RsqrtEstimate(Float a) { return {1.0f / sqrtf(a.v)}; }
+inline Float RcpEstimate(Float a) { return {1.0f / a.v}; }
+#endif
+
+/// One Newton-Raphson step on top of RsqrtEstimate, about 22 bits.
+inline Float Rsqrt(Float a) {
+  Float y = RsqrtEstimate(a);
+  return y * (Float::Set(1.5f) - Float::Set(0.5f) * a * y * y);
+}
+
+/// One Newton-Raphson step on top of RcpEstimate, about 22 bits.
+inline Float Rcp(Float a) {
+  Float y = RcpEstimate(a);
+  return y * (Float::Set(2.0f) - a * y);
+}
+}  // namespace Simd
+}  // namespace Symphony
@@ -1,101 +1,362 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
 
 #include "hash.hpp"
 #include "point2d.hpp"
+#include "segment2d.hpp"
 #include "vector2d.hpp"
 
 namespace Symphony {
 namespace Collision {
-template <typename ObjectType>
+/// \arg Scalar float or Math::Fixed for deterministic lockstep simulation.
+/// RayCast, SweepCast and SegmentQuery are float only.
+template <typename ObjectType, typename Scalar = float>
 class SpatialBin2d {
  public:
-  SpatialBin2d() { buckets_.resize(1024); }
+  static const int kDefaultRehashThreshold = 64;
+  static const int kMaxNumBuckets = 1 << 20;
+
+  SpatialBin2d() { resizeBuckets(1024); }
 
-  SpatialBin2d(float cell_width, float cell_height, int num_buckets)
+  SpatialBin2d(Scalar cell_width, Scalar cell_height, int num_buckets)
       : cell_width_(cell_width), cell_height_(cell_height) {
-    buckets_.resize(num_buckets);
+    resizeBuckets(num_buckets);
+  }
+
+  /// \arg max_hashes_collision When a bucket holds more entries than this and
+  /// they come from different cells the buckets count is doubled. Zero
+  /// disables growing.
+  void SetRehashThreshold(int max_hashes_collision) {
+    rehash_threshold_ = max_hashes_collision;
   }
 
   void Clear() {
     for (int i = 0; i < (int)buckets_.size(); ++i) {
-      buckets_[i].objects.clear();
+      buckets_[i].Clear();
     }
   }
 
-  void Add(const Math::Point2d& center, const Math::Vector2d& half_sizes,
+  void Add(const Math::BasicPoint2d<Scalar>& center,
+           const Math::BasicVector2d<Scalar>& half_sizes,
            const ObjectType& object) {
-    std::vector<uint32_t> buckets_hashes = getBucketsHashes(center, half_sizes);
-    for (int i = 0; i < (int)buckets_hashes.size(); ++i) {
-      int index = (int)(buckets_hashes[i] % buckets_.size());
-      buckets_[index].objects.push_back(object);
+    int i_begin = 0;
+    int i_end = 0;
+    int j_begin = 0;
+    int j_end = 0;
+    rectCovers(center, half_sizes, i_begin, i_end, j_begin, j_end);
+
+    for (int j = j_begin; j < j_end; ++j) {
+      for (int i = i_begin; i < i_end; ++i) {
+        addToCell(Hash::PackInt2(i, j), object);
+      }
     }
   }
 
-  void Query(const Math::Point2d& center, const Math::Vector2d& half_sizes,
+  void Query(const Math::BasicPoint2d<Scalar>& center,
+             const Math::BasicVector2d<Scalar>& half_sizes,
              std::vector<ObjectType>& result_out) const {
     result_out.clear();
+    QueryAppend(center, half_sizes, result_out);
+  }
 
-    std::vector<uint32_t> buckets_hashes = getBucketsHashes(center, half_sizes);
-    for (int i = 0; i < (int)buckets_hashes.size(); ++i) {
-      int index = (int)(buckets_hashes[i] % buckets_.size());
-      for (int j = 0; j < (int)buckets_[index].objects.size(); ++j) {
-        const ObjectType& object = buckets_[index].objects[j];
-
-        bool already_in_result = false;
-        for (int k = 0; k < (int)result_out.size(); ++k) {
-          if (object == result_out[k]) {
-            already_in_result = true;
-            break;
-          }
-        }
+  /// Same as Query but keeps what is already in result_out.
+  void QueryAppend(const Math::BasicPoint2d<Scalar>& center,
+                   const Math::BasicVector2d<Scalar>& half_sizes,
+                   std::vector<ObjectType>& result_out) const {
+    int i_begin = 0;
+    int i_end = 0;
+    int j_begin = 0;
+    int j_end = 0;
+    rectCovers(center, half_sizes, i_begin, i_end, j_begin, j_end);
 
-        if (!already_in_result) {
-          result_out.push_back(buckets_[index].objects[j]);
+    for (int j = j_begin; j < j_end; ++j) {
+      for (int i = i_begin; i < i_end; ++i) {
+        uint64_t cell_key = Hash::PackInt2(i, j);
+        const Bucket& bucket = buckets_[bucketIndex(cell_key)];
+        for (int k = 0; k < (int)bucket.entries.size(); ++k) {
+          const Entry& entry = bucket.entries[k];
+          if (entry.cell_key == cell_key &&
+              !contains(result_out, entry.object)) {
+            result_out.push_back(entry.object);
+          }
         }
       }
     }
   }
 
+  /// Walks cells along the ray (Amanatides-Woo) and tests objects in the
+  /// order the ray reaches them.
+  /// \arg callback Called as callback(object) once per object, returns
+  /// std::optional<float> distance to the hit. Traversal stops as soon as a
+  /// hit is closer than the exit of the current cell.
+  /// Returns the closest reported hit distance.
+  template <typename Callback>
+  std::optional<float> RayCast(const Math::Point2d& ray_start,
+                               const Math::Vector2d& ray_dir_norm,
+                               float max_distance, Callback callback) const {
+    std::optional<float> result;
+    std::vector<ObjectType> tested;
+
+    traverseCells(
+        ray_start, ray_dir_norm, max_distance,
+        [&](int i, int j, float cell_exit_distance) {
+          testCell(Hash::PackInt2(i, j), max_distance, callback, tested,
+                   result);
+
+          // Objects in the farther cells can't be hit before this.
+          return !(result.has_value() && result.value() <= cell_exit_distance);
+        });
+
+    return result;
+  }
+
+  /// Same as RayCast for a rectangle moving by displacement, walks the
+  /// cells along the path of its center and tests everything the rectangle
+  /// can touch from them. Pair with SweepAARect2d or SweepCircle.
+  /// \arg callback Called as callback(object) once per object, returns
+  /// std::optional<float> time of impact as a fraction of displacement.
+  /// Returns the earliest reported time of impact.
+  template <typename Callback>
+  std::optional<float> SweepCast(const Math::Point2d& center,
+                                 const Math::Vector2d& half_sizes,
+                                 const Math::Vector2d& displacement,
+                                 Callback callback) const {
+    std::optional<float> result;
+    std::vector<ObjectType> tested;
+
+    float length = displacement.GetLength();
+    Math::Vector2d dir_norm =
+        length > 0.0f ? displacement * (1.0f / length) : displacement;
+
+    int cover_i = (int)ceilf(half_sizes.x / cell_width_);
+    int cover_j = (int)ceilf(half_sizes.y / cell_height_);
+
+    traverseCells(
+        center, dir_norm, length, [&](int i, int j, float cell_exit_distance) {
+          for (int cell_j = j - cover_j; cell_j <= j + cover_j; ++cell_j) {
+            for (int cell_i = i - cover_i; cell_i <= i + cover_i; ++cell_i) {
+              testCell(Hash::PackInt2(cell_i, cell_j), 1.0f, callback, tested,
+                       result);
+            }
+          }
+
+          return !(result.has_value() &&
+                   result.value() * length <= cell_exit_distance);
+        });
+
+    return result;
+  }
+
+  /// Collects objects from the cells the segment passes through, in the
+  /// order the segment reaches them.
+  void SegmentQuery(const Math::Segment2d& segment,
+                    std::vector<ObjectType>& result_out) const {
+    result_out.clear();
+
+    Math::Vector2d v = segment.p1 - segment.p0;
+    float length = v.GetLength();
+    Math::Vector2d dir_norm = length > 0.0f ? v * (1.0f / length) : v;
+
+    traverseCells(segment.p0, dir_norm, length,
+                  [&](int i, int j, float cell_exit_distance) {
+                    (void)cell_exit_distance;
+                    uint64_t cell_key = Hash::PackInt2(i, j);
+                    const Bucket& bucket = buckets_[bucketIndex(cell_key)];
+                    for (int k = 0; k < (int)bucket.entries.size(); ++k) {
+                      const Entry& entry = bucket.entries[k];
+                      if (entry.cell_key == cell_key &&
+                          !contains(result_out, entry.object)) {
+                        result_out.push_back(entry.object);
+                      }
+                    }
+                    return true;
+                  });
+  }
+
   int GetMaxHashesCollision() const {
     int result = 0;
     for (int i = 0; i < (int)buckets_.size(); ++i) {
-      if (result < (int)buckets_[i].objects.size()) {
-        result = (int)buckets_[i].objects.size();
+      if (result < (int)buckets_[i].entries.size()) {
+        result = (int)buckets_[i].entries.size();
       }
     }
     return result;
   }
 
+  int GetNumBuckets() const { return (int)buckets_.size(); }
+
+  Scalar GetCellWidth() const { return cell_width_; }
+
+  Scalar GetCellHeight() const { return cell_height_; }
+
  private:
-  static uint32_t hash(int i, int j) {
-    uint32_t result = Symphony::Hash::HashLy((unsigned char*)&i, sizeof(int));
-    result = Symphony::Hash::HashLy((unsigned char*)&j, sizeof(int), result);
+  struct Entry {
+    uint64_t cell_key;
+    ObjectType object;
+  };
+
+  struct Bucket {
+    void Add(const Entry& entry) {
+      if (!entries.empty() && entries.front().cell_key != entry.cell_key) {
+        mixed = true;
+      }
+      entries.push_back(entry);
+    }
+
+    void Clear() {
+      entries.clear();
+      mixed = false;
+    }
+
+    std::vector<Entry> entries;
+    /// Entries come from more than one cell.
+    bool mixed{false};
+  };
+
+  static int roundUpToPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value && result < kMaxNumBuckets) {
+      result <<= 1;
+    }
     return result;
   }
 
-  std::vector<uint32_t> getBucketsHashes(
-      const Math::Point2d& center, const Math::Vector2d& half_sizes) const {
-    std::vector<uint32_t> result;
+  void resizeBuckets(int num_buckets) {
+    buckets_.resize(roundUpToPowerOfTwo(num_buckets));
+    buckets_mask_ = (uint64_t)buckets_.size() - 1;
+  }
 
-    int i_begin = 0;
-    int i_end = 0;
-    int j_begin = 0;
-    int j_end = 0;
-    rectCovers(center, half_sizes, i_begin, i_end, j_begin, j_end);
+  int bucketIndex(uint64_t cell_key) const {
+    return (int)(Hash::HashUInt64(cell_key) & buckets_mask_);
+  }
 
-    result.reserve((i_end - i_begin) * (j_end - j_begin));
-    for (int j = j_begin; j < j_end; ++j) {
-      for (int i = i_begin; i < i_end; ++i) {
-        result.push_back(hash(i, j));
+  void addToCell(uint64_t cell_key, const ObjectType& object) {
+    Bucket& bucket = buckets_[bucketIndex(cell_key)];
+    bucket.Add(Entry{cell_key, object});
+
+    // Many objects in one cell is not a collision, growing would not help.
+    if (rehash_threshold_ <= 0 ||
+        (int)bucket.entries.size() <= rehash_threshold_ || !bucket.mixed ||
+        (int)buckets_.size() >= kMaxNumBuckets) {
+      return;
+    }
+    grow();
+  }
+
+  void grow() {
+    std::vector<Bucket> old_buckets;
+    old_buckets.swap(buckets_);
+    resizeBuckets((int)old_buckets.size() * 2);
+
+    for (int i = 0; i < (int)old_buckets.size(); ++i) {
+      for (const Entry& entry : old_buckets[i].entries) {
+        buckets_[bucketIndex(entry.cell_key)].Add(entry);
+      }
+    }
+  }
+
+  // Reports every not yet tested object of the cell to callback and keeps
+  // the smallest hit not greater than max_hit.
+  template <typename Callback>
+  void testCell(uint64_t cell_key, float max_hit, Callback& callback,
+                std::vector<ObjectType>& tested,
+                std::optional<float>& result) const {
+    const Bucket& bucket = buckets_[bucketIndex(cell_key)];
+    for (int k = 0; k < (int)bucket.entries.size(); ++k) {
+      const Entry& entry = bucket.entries[k];
+      if (entry.cell_key != cell_key || contains(tested, entry.object)) {
+        continue;
+      }
+      tested.push_back(entry.object);
+
+      std::optional<float> hit = callback(entry.object);
+      if (hit.has_value() && hit.value() <= max_hit &&
+          (!result.has_value() || hit.value() < result.value())) {
+        result = hit;
+      }
+    }
+  }
+
+  static bool contains(const std::vector<ObjectType>& objects,
+                       const ObjectType& object) {
+    for (int i = 0; i < (int)objects.size(); ++i) {
+      if (object == objects[i]) {
+        return true;
       }
     }
+    return false;
+  }
 
-    return result;
+  // Calls visitor(i, j, cell_exit_distance) for every cell the ray
+  // crosses until it returns false or max_distance is reached.
+  template <typename Visitor>
+  void traverseCells(const Math::Point2d& ray_start,
+                     const Math::Vector2d& ray_dir_norm, float max_distance,
+                     Visitor visitor) const {
+    int i = fDiv(ray_start.x, cell_width_);
+    int j = fDiv(ray_start.y, cell_height_);
+
+    const float kInfinity = std::numeric_limits<float>::infinity();
+
+    int step_i = 0;
+    float distance_to_border_x = kInfinity;
+    float distance_delta_x = kInfinity;
+    if (ray_dir_norm.x > 0.0f) {
+      step_i = 1;
+      distance_to_border_x =
+          ((float)(i + 1) * cell_width_ - ray_start.x) / ray_dir_norm.x;
+      distance_delta_x = cell_width_ / ray_dir_norm.x;
+    } else if (ray_dir_norm.x < 0.0f) {
+      step_i = -1;
+      distance_to_border_x =
+          ((float)i * cell_width_ - ray_start.x) / ray_dir_norm.x;
+      distance_delta_x = -cell_width_ / ray_dir_norm.x;
+    }
+
+    int step_j = 0;
+    float distance_to_border_y = kInfinity;
+    float distance_delta_y = kInfinity;
+    if (ray_dir_norm.y > 0.0f) {
+      step_j = 1;
+      distance_to_border_y =
+          ((float)(j + 1) * cell_height_ - ray_start.y) / ray_dir_norm.y;
+      distance_delta_y = cell_height_ / ray_dir_norm.y;
+    } else if (ray_dir_norm.y < 0.0f) {
+      step_j = -1;
+      distance_to_border_y =
+          ((float)j * cell_height_ - ray_start.y) / ray_dir_norm.y;
+      distance_delta_y = -cell_height_ / ray_dir_norm.y;
+    }
+
+    while (true) {
+      float cell_exit_distance =
+          std::min(distance_to_border_x, distance_to_border_y);
+      if (!visitor(i, j, cell_exit_distance)) {
+        return;
+      }
+      if (cell_exit_distance >= max_distance) {
+        return;
+      }
+
+      if (distance_to_border_x < distance_to_border_y) {
+        i += step_i;
+        distance_to_border_x += distance_delta_x;
+      } else {
+        j += step_j;
+        distance_to_border_y += distance_delta_y;
+      }
+    }
   }
 
-  void rectCovers(const Math::Point2d& center, const Math::Vector2d& half_sizes,
+  void rectCovers(const Math::BasicPoint2d<Scalar>& center,
+                  const Math::BasicVector2d<Scalar>& half_sizes,
                   int& i_begin_out, int& i_end_out, int& j_begin_out,
                   int& j_end_out) const {
     i_begin_out = 0;
@@ -103,13 +364,13 @@ class SpatialBin2d {
     j_begin_out = 0;
     j_end_out = 0;
 
-    float left = center.x - half_sizes.x;
-    float right = center.x + half_sizes.x;
+    Scalar left = center.x - half_sizes.x;
+    Scalar right = center.x + half_sizes.x;
     i_begin_out = fDiv(left, cell_width_);
     i_end_out = fDiv(right, cell_width_) + 1;
 
-    float bottom = center.y - half_sizes.y;
-    float top = center.y + half_sizes.y;
+    Scalar bottom = center.y - half_sizes.y;
+    Scalar top = center.y + half_sizes.y;
     j_begin_out = fDiv(bottom, cell_height_);
     j_end_out = fDiv(top, cell_height_) + 1;
   }
@@ -121,12 +382,12 @@ class SpatialBin2d {
     return (int)(a / b);
   }
 
-  struct Bucket {
-    std::vector<ObjectType> objects;
-  };
+  static int fDiv(Math::Fixed a, Math::Fixed b) { return Math::FloorDiv(a, b); }
 
-  float cell_width_{1.0f};
-  float cell_height_{1.0f};
+  Scalar cell_width_{1};
+  Scalar cell_height_{1};
+  int rehash_threshold_{kDefaultRehashThreshold};
+  uint64_t buckets_mask_{0};
   std::vector<Bucket> buckets_;
 };
 }  // namespace Collision
@@ -0,0 +1,168 @@
+#include "spatial_bins.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "aa_rect2d.hpp"
+#include "continuous_collision.hpp"
+
+using namespace Symphony::Collision;
+using namespace Symphony::Math;
+
+TEST(SpatialBin2d, AddQuery) {
+  SpatialBin2d<int> bins(/* cell_width= */ 10.0f, /* cell_height= */ 10.0f,
+                         /* num_buckets= */ 64);
+  bins.Add(Point2d(5.0f, 5.0f), Vector2d(1.0f, 1.0f), 1);
+  bins.Add(Point2d(-25.0f, 5.0f), Vector2d(1.0f, 1.0f), 2);
+  bins.Add(Point2d(0.0f, 0.0f), Vector2d(30.0f, 30.0f), 3);
+
+  std::vector<int> result;
+  bins.Query(Point2d(5.0f, 5.0f), Vector2d(2.0f, 2.0f), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({1, 3}), result);
+
+  bins.Query(Point2d(-25.0f, 5.0f), Vector2d(2.0f, 2.0f), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({2, 3}), result);
+
+  bins.Query(Point2d(100.0f, 100.0f), Vector2d(2.0f, 2.0f), result);
+  ASSERT_TRUE(result.empty());
+
+  bins.Clear();
+  bins.Query(Point2d(5.0f, 5.0f), Vector2d(2.0f, 2.0f), result);
+  ASSERT_TRUE(result.empty());
+}
+
+TEST(SpatialBin2d, NumBucketsIsPowerOfTwo) {
+  SpatialBin2d<int> bins(1.0f, 1.0f, /* num_buckets= */ 100);
+  ASSERT_EQ(128, bins.GetNumBuckets());
+}
+
+TEST(SpatialBin2d, SharedBucketDoesNotLeakOtherCells) {
+  SpatialBin2d<int> bins(1.0f, 1.0f, /* num_buckets= */ 1);
+  bins.SetRehashThreshold(0);
+  bins.Add(Point2d(0.5f, 0.5f), Vector2d(0.1f, 0.1f), 1);
+  bins.Add(Point2d(5.5f, 5.5f), Vector2d(0.1f, 0.1f), 2);
+  ASSERT_EQ(1, bins.GetNumBuckets());
+
+  std::vector<int> result;
+  bins.Query(Point2d(0.5f, 0.5f), Vector2d(0.1f, 0.1f), result);
+  ASSERT_EQ(std::vector<int>({1}), result);
+}
+
+TEST(SpatialBin2d, GrowsOnCollisions) {
+  SpatialBin2d<int> bins(1.0f, 1.0f, /* num_buckets= */ 4);
+  bins.SetRehashThreshold(8);
+  for (int i = 0; i < 256; ++i) {
+    bins.Add(Point2d((float)i + 0.5f, 0.5f), Vector2d(0.1f, 0.1f), i);
+  }
+  ASSERT_GT(bins.GetNumBuckets(), 4);
+  ASSERT_LE(bins.GetMaxHashesCollision(), 8);
+
+  std::vector<int> result;
+  for (int i = 0; i < 256; ++i) {
+    bins.Query(Point2d((float)i + 0.5f, 0.5f), Vector2d(0.1f, 0.1f), result);
+    ASSERT_EQ(std::vector<int>({i}), result);
+  }
+}
+
+TEST(SpatialBin2d, DoesNotGrowOnCrowdedCell) {
+  SpatialBin2d<int> bins(1.0f, 1.0f, /* num_buckets= */ 4);
+  bins.SetRehashThreshold(8);
+  for (int i = 0; i < 100; ++i) {
+    bins.Add(Point2d(0.5f, 0.5f), Vector2d(0.1f, 0.1f), i);
+  }
+  ASSERT_EQ(4, bins.GetNumBuckets());
+  ASSERT_EQ(100, bins.GetMaxHashesCollision());
+}
+
+TEST(SpatialBin2d, RayCastStopsAtClosestHit) {
+  SpatialBin2d<int> bins(/* cell_width= */ 1.0f, /* cell_height= */ 1.0f,
+                         /* num_buckets= */ 256);
+  std::vector<AARect2d> rects = {
+      AARect2d(Point2d(5.5f, 0.5f), Vector2d(0.25f, 2.0f)),
+      AARect2d(Point2d(-3.5f, 0.5f), Vector2d(0.25f, 0.25f)),
+      AARect2d(Point2d(9.5f, 0.5f), Vector2d(0.25f, 0.25f)),
+      AARect2d(Point2d(2.5f, 3.5f), Vector2d(0.25f, 0.25f)),
+  };
+  for (int i = 0; i < (int)rects.size(); ++i) {
+    bins.Add(rects[i].center, rects[i].half_size, i);
+  }
+
+  Point2d ray_start(0.5f, 0.5f);
+  Vector2d ray_dir(1.0f, 0.0f);
+  std::vector<int> tested;
+  auto distance = bins.RayCast(
+      ray_start, ray_dir, /* max_distance= */ 100.0f,
+      [&](int object) -> std::optional<float> {
+        tested.push_back(object);
+        float d = 0.0f;
+        if (!rects[object].IntersectRay(ray_start, ray_dir, 100.0f, d)) {
+          return std::nullopt;
+        }
+        return d;
+      });
+  ASSERT_TRUE(distance.has_value());
+  ASSERT_NEAR(4.75f, distance.value(), eps);
+  ASSERT_EQ(std::vector<int>({0}), tested);
+
+  tested.clear();
+  distance = bins.RayCast(ray_start, Vector2d(-1.0f, 0.0f),
+                          /* max_distance= */ 2.0f,
+                          [&](int object) -> std::optional<float> {
+                            tested.push_back(object);
+                            return 0.0f;
+                          });
+  ASSERT_FALSE(distance.has_value());
+  ASSERT_TRUE(tested.empty());
+}
+
+TEST(SpatialBin2d, SegmentQuery) {
+  SpatialBin2d<int> bins(/* cell_width= */ 1.0f, /* cell_height= */ 1.0f,
+                         /* num_buckets= */ 256);
+  bins.Add(Point2d(3.5f, 3.5f), Vector2d(0.25f, 0.25f), 1);
+  bins.Add(Point2d(1.5f, 1.5f), Vector2d(0.25f, 0.25f), 2);
+  bins.Add(Point2d(3.5f, 0.5f), Vector2d(0.25f, 0.25f), 3);
+  bins.Add(Point2d(-1.5f, -1.5f), Vector2d(0.25f, 0.25f), 4);
+
+  std::vector<int> result;
+  bins.SegmentQuery(Segment2d(Point2d(0.1f, 0.2f), Point2d(3.9f, 3.8f)),
+                    result);
+  ASSERT_EQ(std::vector<int>({2, 1}), result);
+
+  bins.SegmentQuery(Segment2d(Point2d(0.5f, 0.5f), Point2d(-1.5f, -1.5f)),
+                    result);
+  ASSERT_EQ(std::vector<int>({4}), result);
+}
+
+TEST(SpatialBin2d, SweepCastFindsThinWall) {
+  SpatialBin2d<int> bins(/* cell_width= */ 1.0f, /* cell_height= */ 1.0f,
+                         /* num_buckets= */ 256);
+  std::vector<AARect2d> walls = {
+      AARect2d(Point2d(6.0f, 1.2f), Vector2d(0.05f, 0.25f)),
+      AARect2d(Point2d(3.0f, -2.0f), Vector2d(0.05f, 0.5f)),
+      AARect2d(Point2d(9.0f, 0.5f), Vector2d(0.05f, 2.0f)),
+  };
+  for (int i = 0; i < (int)walls.size(); ++i) {
+    bins.Add(walls[i].center, walls[i].half_size, i);
+  }
+
+  // The first wall is in the cell above the path of the center.
+  AARect2d moving(Point2d(0.5f, 0.5f), Vector2d(0.5f, 0.5f));
+  Vector2d displacement(20.0f, 0.0f);
+  std::vector<int> tested;
+  auto time = bins.SweepCast(moving.center, moving.half_size, displacement,
+                             [&](int object) -> std::optional<float> {
+                               tested.push_back(object);
+                               auto toi = SweepAARect2d(moving, displacement,
+                                                        walls[object]);
+                               if (!toi.has_value()) {
+                                 return std::nullopt;
+                               }
+                               return toi->time;
+                             });
+  ASSERT_TRUE(time.has_value());
+  ASSERT_NEAR(4.95f / 20.0f, time.value(), eps);
+  ASSERT_TRUE(std::find(tested.begin(), tested.end(), 2) == tested.end());
+}
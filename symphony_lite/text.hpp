@@ -2,8 +2,11 @@
 
 #include <SDL3/SDL.h>
 
+#include <stdlib.h>
+
+#include <algorithm>
 #include <fstream>
-#include <unordered_map>
+#include <vector>
 
 #include "formatted_text.hpp"
 #include "log.hpp"
@@ -43,15 +46,36 @@ class TextRenderer {
                 const std::string& default_font,
                 const std::map<std::string, std::shared_ptr<Font>>& fonts);
 
+  /// Adds text as new paragraphs after the current ones, like a line of a
+  /// chat log. Only the new paragraphs are formatted and measured, with the
+  /// variables, font and fonts of the last ReFormat. Text is kept in chunks:
+  /// the loaded file is chunk 0, every call adds one. Tags must be closed in
+  /// the chunk they are opened in.
+  bool AppendText(const std::string& text);
+
+  /// Replaces the text of a chunk, the paragraphs of the other chunks are
+  /// reused. Lines after the chunk only get their render buffers rebuilt.
+  bool ReplaceText(int chunk_index, const std::string& text);
+
+  int GetNumTextChunks() const { return (int)raw_chunks_.size(); }
+
   int GetContentHeight() const { return content_height_; }
 
   void Render(int scroll_y);
 
  private:
-  struct RenderBuffers {
-    std::vector<float> original_ys;
+  // Glyph quads of all lines drawn with one font atlas and one clipping
+  // mode, in line order. Quads of any range of lines are contiguous, so they
+  // take one draw call. Positions are never rewritten, scrolling moves the
+  // viewport.
+  struct AtlasBatch {
+    int GetNumQuads() const { return (int)vertices.size() / 4; }
+
+    Font* font{nullptr};
+    bool clip{true};
     std::vector<SDL_Vertex> vertices;
-    std::vector<int> indices;
+    /// First quad of every line, plus the total count at the end.
+    std::vector<int> line_quad_begins;
   };
 
   struct Line {
@@ -60,7 +84,6 @@ class TextRenderer {
     int max_y{0};
     int align_offset{0};
     Wrapping wrapping{Wrapping::kClip};
-    std::unordered_map<Font*, RenderBuffers> font_to_buffers;
   };
 
   static SDL_FColor SdlColorFromUInt32(uint32_t color) {
@@ -72,22 +95,35 @@ class TextRenderer {
     return sdl_color;
   }
 
+  std::optional<FormattedText> formatChunk(const std::string& text) const;
+  bool updateChunk(int chunk_index, const std::string& text);
+  void rebuildLines(int first_line);
+  AtlasBatch& getBatch(Font* font, bool clip);
+  void appendQuad(const MeasuredGlyph& measured_glyph, float glyph_x,
+                  float glyph_y, float texture_width_scale,
+                  float texture_height_scale, AtlasBatch& batch);
   void updateVisibility(int scroll_y);
-  void updateVisibleLinesPositions(int scroll_y);
 
   std::shared_ptr<SDL_Renderer> sdl_renderer_;
-  std::string raw_text_;
+  std::vector<std::string> raw_chunks_;
+  std::vector<int> chunk_num_paragraphs_;
+  std::map<std::string, std::string> variables_;
+  std::string default_font_;
   std::optional<FormattedText> formatted_text_;
   std::optional<MeasuredText> measured_text_;
   std::vector<Line> lines_;
+  std::vector<AtlasBatch> batches_;
+  // Two triangles per quad, shared by all batches.
+  std::vector<int> quad_indices_;
   int x_{0};
   int y_{0};
   int width_{0};
   int height_{0};
   int content_height_{0};
-  int prev_scroll_y_{0};
   int first_visible_line_index_{-1};
   int last_visible_line_index_{-2};
+  // Scroll the visible range was found for.
+  int visibility_scroll_y_{0};
   const bool draw_debug_{false};
 };
 
@@ -104,10 +140,12 @@ bool TextRenderer::LoadFromFile(const std::string& file_path) {
   file.seekg(0, std::ios::end);
   size_t file_size = file.tellg();
 
-  raw_text_.resize(file_size);
+  std::string raw_text(file_size, '\0');
 
   file.seekg(0, std::ios::beg);
-  file.read(&raw_text_[0], file_size);
+  file.read(&raw_text[0], file_size);
+
+  raw_chunks_.assign(1, std::move(raw_text));
 
   return true;
 }
@@ -116,13 +154,21 @@ void TextRenderer::ReFormat(
     const std::map<std::string, std::string>& variables,
     const std::string& default_font,
     const std::map<std::string, std::shared_ptr<Font>>& fonts) {
-  Style default_style(default_font, /*color*/ 0xFFFFFFFF);
-  ParagraphParameters default_paragraph_parameters(HorizontalAlignment::kLeft,
-                                                   Wrapping::kClip);
-  formatted_text_ = FormatText(raw_text_, default_style,
-                               default_paragraph_parameters, variables);
-  if (!formatted_text_.has_value()) {
-    return;
+  variables_ = variables;
+  default_font_ = default_font;
+
+  formatted_text_ = FormattedText();
+  chunk_num_paragraphs_.clear();
+  for (const auto& raw_chunk : raw_chunks_) {
+    auto formatted_chunk = formatChunk(raw_chunk);
+    if (!formatted_chunk.has_value()) {
+      formatted_text_ = std::nullopt;
+      return;
+    }
+    auto& paragraphs = formatted_text_->paragraphs;
+    paragraphs.insert(paragraphs.end(), formatted_chunk->paragraphs.begin(),
+                      formatted_chunk->paragraphs.end());
+    chunk_num_paragraphs_.push_back((int)formatted_chunk->paragraphs.size());
   }
 
   measured_text_ =
@@ -133,99 +179,130 @@ void TextRenderer::ReFormat(
     return;
   }
 
+  batches_.clear();
+  rebuildLines(0);
+}
+
+bool TextRenderer::AppendText(const std::string& text) {
+  raw_chunks_.push_back(std::string());
+  chunk_num_paragraphs_.push_back(0);
+  if (!updateChunk((int)raw_chunks_.size() - 1, text)) {
+    raw_chunks_.pop_back();
+    chunk_num_paragraphs_.pop_back();
+    return false;
+  }
+  return true;
+}
+
+bool TextRenderer::ReplaceText(int chunk_index, const std::string& text) {
+  if (chunk_index < 0 || chunk_index >= (int)raw_chunks_.size()) {
+    std::cerr << "[Symphony::Text::TextRenderer] No text chunk, chunk_index: "
+              << chunk_index << std::endl;
+    return false;
+  }
+  return updateChunk(chunk_index, text);
+}
+
+std::optional<FormattedText> TextRenderer::formatChunk(
+    const std::string& text) const {
+  Style default_style(default_font_, /*color*/ 0xFFFFFFFF);
+  ParagraphParameters default_paragraph_parameters(HorizontalAlignment::kLeft,
+                                                   Wrapping::kClip);
+  return FormatText(text, default_style, default_paragraph_parameters,
+                    variables_);
+}
+
+bool TextRenderer::updateChunk(int chunk_index, const std::string& text) {
+  // Not formatted yet, the next ReFormat picks the text up.
+  if (!formatted_text_.has_value() || !measured_text_.has_value()) {
+    raw_chunks_[chunk_index] = text;
+    return true;
+  }
+
+  auto formatted_chunk = formatChunk(text);
+  if (!formatted_chunk.has_value()) {
+    return false;
+  }
+
+  int paragraph_begin = 0;
+  for (int i = 0; i < chunk_index; ++i) {
+    paragraph_begin += chunk_num_paragraphs_[i];
+  }
+  int num_old_paragraphs = chunk_num_paragraphs_[chunk_index];
+  int num_new_paragraphs = (int)formatted_chunk->paragraphs.size();
+
+  auto first_line =
+      ReMeasureText(width_, formatted_chunk.value(), paragraph_begin,
+                    num_old_paragraphs, measured_text_.value());
+  if (!first_line.has_value()) {
+    return false;
+  }
+
+  // Moved in once measuring succeeded, appends don't touch the other
+  // paragraphs.
+  auto& paragraphs = formatted_text_->paragraphs;
+  paragraphs.erase(
+      paragraphs.begin() + paragraph_begin,
+      paragraphs.begin() + paragraph_begin + num_old_paragraphs);
+  paragraphs.insert(
+      paragraphs.begin() + paragraph_begin,
+      std::make_move_iterator(formatted_chunk->paragraphs.begin()),
+      std::make_move_iterator(formatted_chunk->paragraphs.end()));
+  raw_chunks_[chunk_index] = text;
+  chunk_num_paragraphs_[chunk_index] = num_new_paragraphs;
+  rebuildLines(first_line.value());
+  return true;
+}
+
+// Lines before first_line and their quads are kept.
+void TextRenderer::rebuildLines(int first_line) {
   MeasuredText& measured_text = measured_text_.value();
+  auto& measured_lines = measured_text.measured_lines;
 
-  lines_.resize(measured_text.measured_lines.size());
+  lines_.resize(measured_lines.size());
+  for (auto& batch : batches_) {
+    int quad_begin = batch.line_quad_begins[first_line];
+    batch.vertices.resize(quad_begin * 4);
+    batch.line_quad_begins.resize(first_line);
+  }
+  first_visible_line_index_ = -1;
+  last_visible_line_index_ = -2;
 
-  int line_y = 0;
-  float line_y_f = 0;
-  for (auto measured_lines_it = measured_text.measured_lines.begin();
-       auto& line : lines_) {
-    const MeasuredTextLine& measured_line = *measured_lines_it;
+  int line_y = first_line > 0 ? lines_[first_line - 1].max_y - y_ : 0;
+  float line_y_f = (float)line_y;
+  for (int line_index = first_line; line_index < (int)measured_lines.size();
+       ++line_index) {
+    const auto& measured_line = measured_lines[line_index];
+    auto& line = lines_[line_index];
     line.line_width = measured_line.line_width;
     line.align_offset = measured_line.align_offset;
     line.wrapping = measured_line.wrapping;
 
     float align_offset = static_cast<float>(measured_line.align_offset);
+    bool clip = measured_line.wrapping != Wrapping::kNoClip;
 
-    for (const auto& [font, glyph_ptrs] : measured_line.font_to_glyph) {
-      auto p =
-          line.font_to_buffers.insert(std::make_pair(font, RenderBuffers()));
-      auto& render_buffers = p.first->second;
-
+    for (int run_index = measured_line.font_run_begin;
+         run_index < measured_line.font_run_end; ++run_index) {
+      const FontRun& font_run = measured_text.font_runs[run_index];
+      Font* font = font_run.font;
       SDL_Texture* sdl_texture = (SDL_Texture*)font->GetTexture();
       if (!sdl_texture) {
         continue;
       }
 
-      int texture_width = sdl_texture->w;
-      int texture_height = sdl_texture->h;
-      float texture_width_scale = 1.0f / (float)texture_width;
-      float texture_height_scale = 1.0f / (float)texture_height;
-
-      (void)texture_width_scale;
-      (void)texture_height_scale;
-
-      render_buffers.original_ys.resize(glyph_ptrs.size());
-      render_buffers.vertices.resize(glyph_ptrs.size() * 4);
-      render_buffers.indices.resize(glyph_ptrs.size() * 6);
-      for (size_t num_glyphs_processed = 0; auto glyph_ptr : glyph_ptrs) {
-        const auto& measured_glyph = *glyph_ptr;
-        const auto& glyph = measured_glyph.glyph;
-
-        SDL_FColor sdl_color = SdlColorFromUInt32(measured_glyph.color);
+      float texture_width_scale = 1.0f / (float)sdl_texture->w;
+      float texture_height_scale = 1.0f / (float)sdl_texture->h;
 
+      AtlasBatch& batch = getBatch(font, clip);
+      // Lines before this one, which have no glyphs in the batch.
+      batch.line_quad_begins.resize(line_index + 1, batch.GetNumQuads());
+      for (int i = font_run.begin; i < font_run.end; ++i) {
+        const auto& measured_glyph =
+            measured_text.glyphs[measured_text.font_glyph_indices[i]];
         float glyph_x = x_ + align_offset + (float)measured_glyph.x;
         float glyph_y = y_ + line_y_f + (float)measured_glyph.y;
-        render_buffers.original_ys[num_glyphs_processed] = glyph_y;
-
-        SDL_Vertex* vertex =
-            &render_buffers.vertices[num_glyphs_processed * 4 + 0];
-        vertex->position.x = glyph_x;
-        vertex->position.y = glyph_y;
-        vertex->color = sdl_color;
-        vertex->tex_coord.x = (float)glyph.texture_x * texture_width_scale;
-        vertex->tex_coord.y = (float)glyph.texture_y * texture_height_scale;
-
-        vertex = &render_buffers.vertices[num_glyphs_processed * 4 + 1];
-        vertex->position.x = glyph_x;
-        vertex->position.y = glyph_y + (float)glyph.texture_height;
-        vertex->color = sdl_color;
-        vertex->tex_coord.x = (float)glyph.texture_x * texture_width_scale;
-        vertex->tex_coord.y = (float)(glyph.texture_y + glyph.texture_height) *
-                              texture_height_scale;
-
-        vertex = &render_buffers.vertices[num_glyphs_processed * 4 + 2];
-        vertex->position.x = glyph_x + (float)glyph.texture_width;
-        vertex->position.y = glyph_y + (float)glyph.texture_height;
-        vertex->color = sdl_color;
-        vertex->tex_coord.x = (float)(glyph.texture_x + glyph.texture_width) *
-                              texture_width_scale;
-        vertex->tex_coord.y = (float)(glyph.texture_y + glyph.texture_height) *
-                              texture_height_scale;
-
-        vertex = &render_buffers.vertices[num_glyphs_processed * 4 + 3];
-        vertex->position.x = glyph_x + (float)glyph.texture_width;
-        vertex->position.y = glyph_y;
-        vertex->color = sdl_color;
-        vertex->tex_coord.x = (float)(glyph.texture_x + glyph.texture_width) *
-                              texture_width_scale;
-        vertex->tex_coord.y = (float)(glyph.texture_y) * texture_height_scale;
-
-        render_buffers.indices[num_glyphs_processed * 6 + 0] =
-            num_glyphs_processed * 4 + 0;
-        render_buffers.indices[num_glyphs_processed * 6 + 1] =
-            num_glyphs_processed * 4 + 2;
-        render_buffers.indices[num_glyphs_processed * 6 + 2] =
-            num_glyphs_processed * 4 + 1;
-        render_buffers.indices[num_glyphs_processed * 6 + 3] =
-            num_glyphs_processed * 4 + 0;
-        render_buffers.indices[num_glyphs_processed * 6 + 4] =
-            num_glyphs_processed * 4 + 3;
-        render_buffers.indices[num_glyphs_processed * 6 + 5] =
-            num_glyphs_processed * 4 + 2;
-
-        ++num_glyphs_processed;
+        appendQuad(measured_glyph, glyph_x, glyph_y, texture_width_scale,
+                   texture_height_scale, batch);
       }
     }
 
@@ -233,8 +310,26 @@ void TextRenderer::ReFormat(
     line.max_y = y_ + line_y + measured_line.line_height;
     line_y += measured_line.line_height;
     line_y_f += (float)measured_line.line_height;
+  }
 
-    ++measured_lines_it;
+  size_t max_num_quads = 0;
+  for (auto& batch : batches_) {
+    batch.line_quad_begins.resize(lines_.size() + 1, batch.GetNumQuads());
+    max_num_quads = std::max(max_num_quads, (size_t)batch.GetNumQuads());
+  }
+
+  if (quad_indices_.size() < max_num_quads * 6) {
+    size_t num_quads = quad_indices_.size() / 6;
+    quad_indices_.resize(max_num_quads * 6);
+    for (size_t i = num_quads; i < max_num_quads; ++i) {
+      int vertex = (int)i * 4;
+      quad_indices_[i * 6 + 0] = vertex + 0;
+      quad_indices_[i * 6 + 1] = vertex + 2;
+      quad_indices_[i * 6 + 2] = vertex + 1;
+      quad_indices_[i * 6 + 3] = vertex + 0;
+      quad_indices_[i * 6 + 4] = vertex + 3;
+      quad_indices_[i * 6 + 5] = vertex + 2;
+    }
   }
 
   content_height_ = 0;
@@ -253,13 +348,15 @@ void TextRenderer::Render(int scroll_y) {
   }
 
   updateVisibility(scroll_y);
-  if (prev_scroll_y_ != scroll_y) {
-    updateVisibleLinesPositions(scroll_y);
-  }
-  prev_scroll_y_ = scroll_y;
 
+  bool prev_clip_enabled = SDL_RenderClipEnabled(sdl_renderer_.get());
   SDL_Rect prev_clip_rect;
   SDL_GetRenderClipRect(sdl_renderer_.get(), &prev_clip_rect);
+  // Without an explicit viewport the renderer follows the target size, it
+  // must stay that way.
+  bool prev_viewport_set = SDL_RenderViewportSet(sdl_renderer_.get());
+  SDL_Rect prev_viewport;
+  SDL_GetRenderViewport(sdl_renderer_.get(), &prev_viewport);
 
   if (draw_debug_) {
     Uint8 r = 0, g = 0, b = 0, a = 0;
@@ -272,90 +369,165 @@ void TextRenderer::Render(int scroll_y) {
     SDL_SetRenderDrawColor(sdl_renderer_.get(), r, g, b, a);
   }
 
-  SDL_Rect clip_rect(x_, y_, width_, height_);
+  // Scrolling moves the viewport instead of the vertices. Its bottom edge
+  // stays in place, clip rects are relative to it.
+  SDL_Rect scrolled_viewport(prev_viewport.x, prev_viewport.y + scroll_y,
+                             prev_viewport.w, prev_viewport.h - scroll_y);
+  // Scrolled below the bottom edge, nothing to draw.
+  if (scrolled_viewport.h <= 0) {
+    return;
+  }
+  SDL_SetRenderViewport(sdl_renderer_.get(), &scrolled_viewport);
+  SDL_Rect clip_rect(x_, y_ - scroll_y, width_, height_);
+  SDL_Rect scrolled_prev_clip_rect(prev_clip_rect.x,
+                                   prev_clip_rect.y - scroll_y,
+                                   prev_clip_rect.w, prev_clip_rect.h);
+  SDL_SetRenderClipRect(sdl_renderer_.get(),
+                        prev_clip_enabled ? &scrolled_prev_clip_rect : nullptr);
 
   SDL_SetRenderDrawBlendMode(sdl_renderer_.get(), SDL_BLENDMODE_BLEND);
 
-  for (int line_index = first_visible_line_index_;
-       line_index <= last_visible_line_index_; ++line_index) {
-    auto& line = lines_[line_index];
-
-    bool reset_clipping = false;
-    if (!draw_debug_) {
-      if (line.wrapping != Wrapping::kNoClip) {
-        SDL_SetRenderClipRect(sdl_renderer_.get(), &clip_rect);
-        reset_clipping = true;
-      }
-    }
-
-    if (draw_debug_) {
-      Uint8 r = 0, g = 0, b = 0, a = 0;
-      SDL_GetRenderDrawColor(sdl_renderer_.get(), &r, &g, &b, &a);
+  if (draw_debug_) {
+    Uint8 r = 0, g = 0, b = 0, a = 0;
+    SDL_GetRenderDrawColor(sdl_renderer_.get(), &r, &g, &b, &a);
 
-      SDL_SetRenderDrawColor(sdl_renderer_.get(), 128, 128, 128, 128);
-      SDL_FRect debug_rect{(float)line.align_offset + x_,
-                           (float)scroll_y + line.min_y, (float)line.line_width,
+    SDL_SetRenderDrawColor(sdl_renderer_.get(), 128, 128, 128, 128);
+    for (int line_index = first_visible_line_index_;
+         line_index <= last_visible_line_index_; ++line_index) {
+      auto& line = lines_[line_index];
+      SDL_FRect debug_rect{(float)line.align_offset + x_, (float)line.min_y,
+                           (float)line.line_width,
                            (float)line.max_y - line.min_y};
       SDL_RenderFillRect(sdl_renderer_.get(), &debug_rect);
-
-      SDL_SetRenderDrawColor(sdl_renderer_.get(), r, g, b, a);
     }
 
-    for (auto& [font, buffers] : line.font_to_buffers) {
-      SDL_Texture* sdl_texture = (SDL_Texture*)font->GetTexture();
-      SDL_SetTextureBlendMode(sdl_texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(sdl_renderer_.get(), r, g, b, a);
+  }
 
-      SDL_RenderGeometry(sdl_renderer_.get(), sdl_texture, &buffers.vertices[0],
-                         buffers.vertices.size(), &buffers.indices[0],
-                         buffers.indices.size());
+  // One draw call per atlas and clipping mode, clipped batches share one
+  // clip rect change.
+  for (bool clip : {true, false}) {
+    bool set_clipping = clip && !draw_debug_;
+    if (set_clipping) {
+      SDL_SetRenderClipRect(sdl_renderer_.get(), &clip_rect);
     }
 
-    if (reset_clipping) {
-      SDL_SetRenderClipRect(sdl_renderer_.get(), &prev_clip_rect);
-    }
-  }
-}
+    for (auto& batch : batches_) {
+      if (batch.clip != clip || first_visible_line_index_ < 0) {
+        continue;
+      }
 
-void TextRenderer::updateVisibility(int scroll_y) {
-  first_visible_line_index_ = -1;
-  last_visible_line_index_ = -2;
+      int quad_begin = batch.line_quad_begins[first_visible_line_index_];
+      int quad_end = batch.line_quad_begins[last_visible_line_index_ + 1];
+      if (quad_begin == quad_end) {
+        continue;
+      }
 
-  for (int line_index = 0; auto& line : lines_) {
-    if ((scroll_y + line.max_y) < y_) {
-      ++line_index;
-      continue;
-    }
-    if ((scroll_y + line.min_y) > y_ + height_) {
-      break;
+      SDL_Texture* sdl_texture = (SDL_Texture*)batch.font->GetTexture();
+      SDL_SetTextureBlendMode(sdl_texture, SDL_BLENDMODE_BLEND);
+
+      SDL_RenderGeometry(sdl_renderer_.get(), sdl_texture,
+                         &batch.vertices[quad_begin * 4],
+                         (quad_end - quad_begin) * 4, &quad_indices_[0],
+                         (quad_end - quad_begin) * 6);
     }
 
-    if (first_visible_line_index_ == -1) {
-      first_visible_line_index_ = line_index;
+    if (set_clipping) {
+      SDL_SetRenderClipRect(
+          sdl_renderer_.get(),
+          prev_clip_enabled ? &scrolled_prev_clip_rect : nullptr);
     }
+  }
 
-    last_visible_line_index_ = line_index;
+  SDL_SetRenderViewport(sdl_renderer_.get(),
+                        prev_viewport_set ? &prev_viewport : nullptr);
+  SDL_SetRenderClipRect(sdl_renderer_.get(),
+                        prev_clip_enabled ? &prev_clip_rect : nullptr);
+}
 
-    ++line_index;
+TextRenderer::AtlasBatch& TextRenderer::getBatch(Font* font, bool clip) {
+  for (auto& batch : batches_) {
+    if (batch.font == font && batch.clip == clip) {
+      return batch;
+    }
   }
+
+  batches_.push_back(AtlasBatch());
+  batches_.back().font = font;
+  batches_.back().clip = clip;
+  return batches_.back();
 }
 
-void TextRenderer::updateVisibleLinesPositions(int scroll_y) {
-  for (int line_index = first_visible_line_index_;
-       line_index <= last_visible_line_index_; ++line_index) {
-    auto& line = lines_[line_index];
+void TextRenderer::appendQuad(const MeasuredGlyph& measured_glyph,
+                              float glyph_x, float glyph_y,
+                              float texture_width_scale,
+                              float texture_height_scale, AtlasBatch& batch) {
+  const auto& glyph = measured_glyph.glyph;
+  SDL_FColor sdl_color = SdlColorFromUInt32(measured_glyph.color);
+
+  float left = glyph_x;
+  float right = glyph_x + (float)glyph.texture_width;
+  float top = glyph_y;
+  float bottom = glyph_y + (float)glyph.texture_height;
+  float u_left = (float)glyph.texture_x * texture_width_scale;
+  float u_right =
+      (float)(glyph.texture_x + glyph.texture_width) * texture_width_scale;
+  float v_top = (float)glyph.texture_y * texture_height_scale;
+  float v_bottom =
+      (float)(glyph.texture_y + glyph.texture_height) * texture_height_scale;
+
+  batch.vertices.push_back(
+      SDL_Vertex{{left, top}, sdl_color, {u_left, v_top}});
+  batch.vertices.push_back(
+      SDL_Vertex{{left, bottom}, sdl_color, {u_left, v_bottom}});
+  batch.vertices.push_back(
+      SDL_Vertex{{right, bottom}, sdl_color, {u_right, v_bottom}});
+  batch.vertices.push_back(
+      SDL_Vertex{{right, top}, sdl_color, {u_right, v_top}});
+}
 
-    for (auto& [font, buffers] : line.font_to_buffers) {
-      for (size_t i = 0; i < buffers.vertices.size() / 4; ++i) {
-        float y = buffers.original_ys[i];
-        float height = buffers.vertices[i * 4 + 1].position.y -
-                       buffers.vertices[i * 4 + 0].position.y;
-        buffers.vertices[i * 4 + 0].position.y = y + scroll_y;
-        buffers.vertices[i * 4 + 1].position.y = y + height + scroll_y;
-        buffers.vertices[i * 4 + 2].position.y = y + height + scroll_y;
-        buffers.vertices[i * 4 + 3].position.y = y + scroll_y;
-      }
+// Line bounds only grow with the index, so the visible lines are found by
+// binary search, or by walking from the last range when the scroll moved
+// less than a screen.
+void TextRenderer::updateVisibility(int scroll_y) {
+  int num_lines = (int)lines_.size();
+  int top = y_ - scroll_y;
+  int bottom = y_ + height_ - scroll_y;
+
+  int first = first_visible_line_index_;
+  int last = last_visible_line_index_;
+  if (first >= 0 && std::abs(scroll_y - visibility_scroll_y_) <= height_) {
+    while (first > 0 && lines_[first - 1].max_y >= top) {
+      --first;
+    }
+    while (first < num_lines && lines_[first].max_y < top) {
+      ++first;
     }
+    while (last + 1 < num_lines && lines_[last + 1].min_y <= bottom) {
+      ++last;
+    }
+    while (last >= 0 && lines_[last].min_y > bottom) {
+      --last;
+    }
+  } else {
+    auto first_it = std::partition_point(
+        lines_.begin(), lines_.end(),
+        [top](const Line& line) { return line.max_y < top; });
+    auto end_it = std::partition_point(
+        lines_.begin(), lines_.end(),
+        [bottom](const Line& line) { return line.min_y <= bottom; });
+    first = (int)(first_it - lines_.begin());
+    last = (int)(end_it - lines_.begin()) - 1;
+  }
+
+  visibility_scroll_y_ = scroll_y;
+  if (first > last) {
+    first_visible_line_index_ = -1;
+    last_visible_line_index_ = -2;
+    return;
   }
+  first_visible_line_index_ = first;
+  last_visible_line_index_ = last;
 }
 
 }  // namespace Text
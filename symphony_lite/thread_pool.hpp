@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Symphony {
+namespace Threading {
+// Fixed set of worker threads for data parallel loops. Threads sleep between
+// loops, so one pool can be kept for the whole run.
+class ThreadPool {
+ public:
+  /// \arg num_threads Workers besides the calling thread. Zero runs every
+  /// loop on the caller, for single core targets.
+  explicit ThreadPool(int num_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this]() { workerLoop(); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    job_ready_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  int GetNumThreads() const { return (int)threads_.size(); }
+
+  /// Splits [begin, end) into ranges of range_size and calls
+  /// fn(range_begin, range_end) for each of them on the workers and the
+  /// calling thread. Returns when all ranges are done. Not reentrant: fn
+  /// must not call ParallelFor.
+  template <typename Fn>
+  void ParallelFor(int begin, int end, int range_size, const Fn& fn) {
+    if (begin >= end) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &fn;
+      invoke_ = [](const void* job, int range_begin, int range_end) {
+        (*(const Fn*)job)(range_begin, range_end);
+      };
+      end_ = end;
+      range_size_ = std::max(range_size, 1);
+      next_range_.store(begin);
+      active_workers_ = (int)threads_.size();
+      ++generation_;
+    }
+    job_ready_.notify_all();
+
+    runRanges();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_done_.wait(lock, [this]() { return active_workers_ == 0; });
+  }
+
+ private:
+  void workerLoop() {
+    uint64_t seen_generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ready_.wait(lock, [&]() {
+          return stopping_ || generation_ != seen_generation;
+        });
+        if (stopping_) {
+          return;
+        }
+        seen_generation = generation_;
+      }
+
+      runRanges();
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--active_workers_ == 0) {
+        job_done_.notify_one();
+      }
+    }
+  }
+
+  void runRanges() {
+    while (true) {
+      int range_begin = next_range_.fetch_add(range_size_);
+      if (range_begin >= end_) {
+        return;
+      }
+      invoke_(job_, range_begin, std::min(range_begin + range_size_, end_));
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable job_ready_;
+  std::condition_variable job_done_;
+  bool stopping_{false};
+  uint64_t generation_{0};
+  int active_workers_{0};
+
+  // Current loop, written under mutex_ before workers are woken up.
+  const void* job_{nullptr};
+  void (*invoke_)(const void* job, int range_begin, int range_end){nullptr};
+  int end_{0};
+  int range_size_{1};
+  std::atomic<int> next_range_{0};
+};
+}  // namespace Threading
+}  // namespace Symphony
@@ -0,0 +1,35 @@
+#include "thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace Symphony::Threading;
+
+TEST(ThreadPool, ParallelForVisitsEveryIndexOnce) {
+  for (int num_threads : {0, 1, 4}) {
+    ThreadPool pool(num_threads);
+    ASSERT_EQ(num_threads, pool.GetNumThreads());
+
+    std::vector<int> visits(1000, 0);
+    for (int iteration = 0; iteration < 100; ++iteration) {
+      pool.ParallelFor(3, 997, /* range_size= */ 7,
+                       [&](int range_begin, int range_end) {
+                         ASSERT_LE(range_end - range_begin, 7);
+                         for (int i = range_begin; i < range_end; ++i) {
+                           ++visits[i];
+                         }
+                       });
+    }
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_EQ(i >= 3 && i < 997 ? 100 : 0, visits[i]);
+    }
+  }
+}
+
+TEST(ThreadPool, EmptyRange) {
+  ThreadPool pool(2);
+  int calls = 0;
+  pool.ParallelFor(5, 5, 1, [&](int, int) { ++calls; });
+  ASSERT_EQ(0, calls);
+}
@@ -1,12 +1,24 @@
 #pragma once
 
+#if defined(__SSE2__)
+#include <xmmintrin.h>
+#endif
+
+#include <math.h>
+
+#include <optional>
+#include <vector>
+
 #include "angle.hpp"
 #include "point3d.hpp"
+#include "quaternion.hpp"
 #include "vector3d.hpp"
 
 namespace Symphony {
 namespace Math {
-class TransformationMatrix3d {
+// Points are row vectors multiplied from the left, rows m41..m43 hold the
+// translation. Storage is 16 byte aligned so every row is one SSE register.
+class alignas(16) TransformationMatrix3d {
  public:
   static const int kNumColumns = 4;
   static const int kNumRows = 4;
@@ -66,8 +78,51 @@ class TransformationMatrix3d {
     MakeTranslation(translate.x, translate.y, translate.z);
   }
 
-  // TODO(truvorskameikin): Implement MakeRotation. Need to implememnt
-  // Quaternion and Rotation classes.
+  void MakeRotation(const Quaternion& rotation_norm) {
+    MakeTransformation(Vector3d(), rotation_norm, Vector3d(1.0f, 1.0f, 1.0f));
+  }
+
+  void MakeRotation(const Vector3d& axis_norm, float angle_rad) {
+    MakeRotation(Quaternion(axis_norm, angle_rad));
+  }
+
+  /// Same as translation * rotation * scale, but written directly without
+  /// matrix multiplies.
+  void MakeTransformation(const Vector3d& translate,
+                          const Quaternion& rotation_norm,
+                          const Vector3d& scale) {
+    const Quaternion& q = rotation_norm;
+    float xx = q.x * q.x;
+    float yy = q.y * q.y;
+    float zz = q.z * q.z;
+    float xy = q.x * q.y;
+    float xz = q.x * q.z;
+    float yz = q.y * q.z;
+    float wx = q.w * q.x;
+    float wy = q.w * q.y;
+    float wz = q.w * q.z;
+
+    // Rows are the images of the axes.
+    m11 = (1.0f - 2.0f * (yy + zz)) * scale.x;
+    m12 = 2.0f * (xy + wz) * scale.x;
+    m13 = 2.0f * (xz - wy) * scale.x;
+    m14 = 0.0f;
+
+    m21 = 2.0f * (xy - wz) * scale.y;
+    m22 = (1.0f - 2.0f * (xx + zz)) * scale.y;
+    m23 = 2.0f * (yz + wx) * scale.y;
+    m24 = 0.0f;
+
+    m31 = 2.0f * (xz + wy) * scale.z;
+    m32 = 2.0f * (yz - wx) * scale.z;
+    m33 = (1.0f - 2.0f * (xx + yy)) * scale.z;
+    m34 = 0.0f;
+
+    m41 = translate.x;
+    m42 = translate.y;
+    m43 = translate.z;
+    m44 = 1.0f;
+  }
 
   void MakePerspective(float horizontal_fov_deg, float aspect_ratio,
                        float near_z, float far_z) {
@@ -113,6 +168,20 @@ class TransformationMatrix3d {
 
     const float* m = &m11;
     const float* rhv_m = &rhv.m11;
+#if defined(__SSE2__)
+    __m128 row0 = _mm_load_ps(m + 0 * 4);
+    __m128 row1 = _mm_load_ps(m + 1 * 4);
+    __m128 row2 = _mm_load_ps(m + 2 * 4);
+    __m128 row3 = _mm_load_ps(m + 3 * 4);
+    for (int i = 0; i < 4; ++i) {
+      __m128 row = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(rhv_m[i * 4 + 0]), row0),
+                     _mm_mul_ps(_mm_set1_ps(rhv_m[i * 4 + 1]), row1)),
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(rhv_m[i * 4 + 2]), row2),
+                     _mm_mul_ps(_mm_set1_ps(rhv_m[i * 4 + 3]), row3)));
+      _mm_store_ps(result_m + i * 4, row);
+    }
+#else
     for (int i = 0; i < 4; ++i) {
       for (int j = 0; j < 4; ++j) {
         result_m[i * 4 + j] =
@@ -120,7 +189,108 @@ class TransformationMatrix3d {
             m[2 * 4 + j] * rhv_m[i * 4 + 2] + m[3 * 4 + j] * rhv_m[i * 4 + 3];
       }
     }
+#endif
+
+    return result;
+  }
+
+  /// Inverse of any non singular matrix, std::nullopt for singular ones.
+  std::optional<TransformationMatrix3d> GetInverse() const {
+    const float* m = &m11;
+    TransformationMatrix3d result(/* make_identity= */ false);
+    float* inv = &result.m11;
+
+    // Cofactor expansion, the result is the transposed cofactor matrix
+    // divided by determinant.
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] -
+             m[9] * m[6] * m[15] + m[9] * m[7] * m[14] +
+             m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] +
+             m[8] * m[6] * m[15] - m[8] * m[7] * m[14] -
+             m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] -
+             m[8] * m[5] * m[15] + m[8] * m[7] * m[13] +
+             m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] +
+              m[8] * m[5] * m[14] - m[8] * m[6] * m[13] -
+              m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] +
+             m[9] * m[2] * m[15] - m[9] * m[3] * m[14] -
+             m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] -
+             m[8] * m[2] * m[15] + m[8] * m[3] * m[14] +
+             m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] +
+             m[8] * m[1] * m[15] - m[8] * m[3] * m[13] -
+             m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] -
+              m[8] * m[1] * m[14] + m[8] * m[2] * m[13] +
+              m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] -
+             m[5] * m[2] * m[15] + m[5] * m[3] * m[14] +
+             m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] +
+             m[4] * m[2] * m[15] - m[4] * m[3] * m[14] -
+             m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] -
+              m[4] * m[1] * m[15] + m[4] * m[3] * m[13] +
+              m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] +
+              m[4] * m[1] * m[14] - m[4] * m[2] * m[13] -
+              m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] +
+             m[5] * m[2] * m[11] - m[5] * m[3] * m[10] -
+             m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] -
+             m[4] * m[2] * m[11] + m[4] * m[3] * m[10] +
+             m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] +
+              m[4] * m[1] * m[11] - m[4] * m[3] * m[9] -
+              m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] -
+              m[4] * m[1] * m[10] + m[4] * m[2] * m[9] +
+              m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float determinant =
+        m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (determinant == 0.0f) {
+      return std::nullopt;
+    }
+
+    float determinant_inv = 1.0f / determinant;
+    for (int i = 0; i < kSize; ++i) {
+      inv[i] *= determinant_inv;
+    }
+    return result;
+  }
 
+  /// Cheaper inverse for matrices built from scale, rotation and translation
+  /// (m14, m24, m34 are 0 and m44 is 1), e.g. model and view matrices.
+  std::optional<TransformationMatrix3d> GetAffineInverse() const {
+    // Inverse of [A 0; t 1] is [A^-1 0; -t * A^-1 1].
+    float c11 = m22 * m33 - m23 * m32;
+    float c12 = m23 * m31 - m21 * m33;
+    float c13 = m21 * m32 - m22 * m31;
+    float determinant = m11 * c11 + m12 * c12 + m13 * c13;
+    if (determinant == 0.0f) {
+      return std::nullopt;
+    }
+    float determinant_inv = 1.0f / determinant;
+
+    TransformationMatrix3d result;
+    result.m11 = c11 * determinant_inv;
+    result.m12 = (m13 * m32 - m12 * m33) * determinant_inv;
+    result.m13 = (m12 * m23 - m13 * m22) * determinant_inv;
+    result.m21 = c12 * determinant_inv;
+    result.m22 = (m11 * m33 - m13 * m31) * determinant_inv;
+    result.m23 = (m13 * m21 - m11 * m23) * determinant_inv;
+    result.m31 = c13 * determinant_inv;
+    result.m32 = (m12 * m31 - m11 * m32) * determinant_inv;
+    result.m33 = (m11 * m22 - m12 * m21) * determinant_inv;
+
+    result.m41 = -(m41 * result.m11 + m42 * result.m21 + m43 * result.m31);
+    result.m42 = -(m41 * result.m12 + m42 * result.m22 + m43 * result.m32);
+    result.m43 = -(m41 * result.m13 + m42 * result.m23 + m43 * result.m33);
     return result;
   }
 
@@ -144,8 +314,40 @@ class TransformationMatrix3d {
     return result;
   }
 
-#pragma pack(push)
-#pragma pack(1)
+  /// Transforms whole vertex lists, rows stay in registers for the batch.
+  void Transform(const std::vector<Point3d>& points,
+                 std::vector<Point3d>& result_out) const {
+    result_out.resize(points.size());
+    Transform(points.data(), (int)points.size(), result_out.data());
+  }
+
+  /// \arg points_out Can be the same as points.
+  void Transform(const Point3d* points, int num_points,
+                 Point3d* points_out) const {
+#if defined(__SSE2__)
+    const float* m = &m11;
+    __m128 row0 = _mm_load_ps(m + 0 * 4);
+    __m128 row1 = _mm_load_ps(m + 1 * 4);
+    __m128 row2 = _mm_load_ps(m + 2 * 4);
+    __m128 row3 = _mm_load_ps(m + 3 * 4);
+    alignas(16) float transformed[4];
+    for (int i = 0; i < num_points; ++i) {
+      const Point3d& p = points[i];
+      __m128 result = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), row0),
+                     _mm_mul_ps(_mm_set1_ps(p.y), row1)),
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), row2), row3));
+      _mm_store_ps(transformed, result);
+      points_out[i] = Point3d(transformed[0], transformed[1], transformed[2]);
+    }
+#else
+    for (int i = 0; i < num_points; ++i) {
+      Point3d p = points[i];
+      transform(&p.x, 1.0f, &points_out[i].x);
+    }
+#endif
+  }
+
   float m11;
   float m12;
   float m13;
@@ -165,10 +367,22 @@ class TransformationMatrix3d {
   float m42;
   float m43;
   float m44;
-#pragma pack(pop)
 
  private:
   void transform(const float* vec, float w, float* vec_out) const {
+#if defined(__SSE2__)
+    const float* m = &m11;
+    __m128 result = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(vec[0]), _mm_load_ps(m + 0 * 4)),
+                   _mm_mul_ps(_mm_set1_ps(vec[1]), _mm_load_ps(m + 1 * 4))),
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(vec[2]), _mm_load_ps(m + 2 * 4)),
+                   _mm_mul_ps(_mm_set1_ps(w), _mm_load_ps(m + 3 * 4))));
+    alignas(16) float transformed[4];
+    _mm_store_ps(transformed, result);
+    vec_out[0] = transformed[0];
+    vec_out[1] = transformed[1];
+    vec_out[2] = transformed[2];
+#else
     const float* m = &m11;
     vec_out[0] = vec[0] * m[0 * 4 + 0] + vec[1] * m[1 * 4 + 0] +
                  vec[2] * m[2 * 4 + 0] + w * m[3 * 4 + 0];
@@ -176,6 +390,7 @@ class TransformationMatrix3d {
                  vec[2] * m[2 * 4 + 1] + w * m[3 * 4 + 1];
     vec_out[2] = vec[0] * m[0 * 4 + 2] + vec[1] * m[1 * 4 + 2] +
                  vec[2] * m[2 * 4 + 2] + w * m[3 * 4 + 2];
+#endif
   }
 };
 }  // namespace Math
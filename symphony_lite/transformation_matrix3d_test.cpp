@@ -111,3 +111,76 @@ TEST(TransformationMatrix3d, LookAtMatrix2) {
                           Point2d(pp3.x, pp3.y), 0.0001f);
   ASSERT_TRUE(result);
 }
+
+namespace {
+void ExpectIdentity(const TransformationMatrix3d& m) {
+  TransformationMatrix3d identity;
+  const float* m_values = &m.m11;
+  const float* identity_values = &identity.m11;
+  for (int i = 0; i < TransformationMatrix3d::kSize; ++i) {
+    ASSERT_NEAR(identity_values[i], m_values[i], 0.0001f);
+  }
+}
+}  // namespace
+
+TEST(TransformationMatrix3d, Inverse) {
+  TransformationMatrix3d tr;
+  tr.MakeTranslation(1.0f, 2.0f, 3.0f);
+  TransformationMatrix3d s;
+  s.MakeScale(2.0f, 3.0f, 4.0f);
+  TransformationMatrix3d look_at;
+  look_at.MakeLookAt(Point3d(2.0f, 3.0f, 1.0f),
+                     Vector3d(1.0f, 1.0f, 0.0f).GetNormalized(),
+                     Vector3d(0.0f, 0.0f, 1.0f));
+  TransformationMatrix3d perspective;
+  perspective.MakePerspective(90.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+
+  TransformationMatrix3d affine = look_at * s * tr;
+  auto inverse = affine.GetInverse();
+  ASSERT_TRUE(inverse.has_value());
+  ExpectIdentity(affine * inverse.value());
+
+  auto affine_inverse = affine.GetAffineInverse();
+  ASSERT_TRUE(affine_inverse.has_value());
+  ExpectIdentity(affine_inverse.value() * affine);
+
+  TransformationMatrix3d projection = perspective * affine;
+  inverse = projection.GetInverse();
+  ASSERT_TRUE(inverse.has_value());
+  ExpectIdentity(inverse.value() * projection);
+
+  TransformationMatrix3d flat;
+  flat.MakeScale(1.0f, 0.0f, 1.0f);
+  ASSERT_FALSE(flat.GetInverse().has_value());
+  ASSERT_FALSE(flat.GetAffineInverse().has_value());
+}
+
+TEST(TransformationMatrix3d, TransformBatch) {
+  TransformationMatrix3d m;
+  m.MakeLookAt(Point3d(2.0f, 3.0f, 1.0f),
+               Vector3d(1.0f, 1.0f, 0.0f).GetNormalized(),
+               Vector3d(0.0f, 0.0f, 1.0f));
+  TransformationMatrix3d s;
+  s.MakeScale(2.0f, 3.0f, 4.0f);
+  m = m * s;
+
+  std::vector<Point3d> points;
+  for (int i = 0; i < 10; ++i) {
+    points.push_back(Point3d((float)i, 2.0f * (float)i, -(float)i));
+  }
+  std::vector<Point3d> transformed;
+  m.Transform(points, transformed);
+  ASSERT_EQ(points.size(), transformed.size());
+  for (int i = 0; i < (int)points.size(); ++i) {
+    Point3d expected = m * points[i];
+    ASSERT_NEAR(expected.x, transformed[i].x, 0.0001f);
+    ASSERT_NEAR(expected.y, transformed[i].y, 0.0001f);
+    ASSERT_NEAR(expected.z, transformed[i].z, 0.0001f);
+  }
+
+  // In place.
+  m.Transform(points.data(), (int)points.size(), points.data());
+  for (int i = 0; i < (int)points.size(); ++i) {
+    ASSERT_NEAR(transformed[i].x, points[i].x, 0.0001f);
+  }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <vector>
+
+#include "aligned_allocator.hpp"
+#include "simd.hpp"
+#include "vector2d.hpp"
+
+namespace Symphony {
+namespace Math {
+// Structure of arrays batch of 2d vectors (or points) for hot loops over
+// thousands of particles. Storage is aligned and padded with zeros up to
+// the SIMD width so every operation is a single vector pass without a
+// scalar tail. Operations taking another array expect it to have the same
+// size.
+class Vec2Array {
+ public:
+  Vec2Array() {}
+
+  explicit Vec2Array(int size) { Resize(size); }
+
+  void Resize(int size) {
+    int padded_size = paddedSize(size);
+    x_.resize(padded_size, 0.0f);
+    y_.resize(padded_size, 0.0f);
+    // Padding could have been written by bulk operations.
+    for (int i = size_; i < size && i < padded_size; ++i) {
+      x_[i] = 0.0f;
+      y_[i] = 0.0f;
+    }
+    size_ = size;
+  }
+
+  void Clear() { Resize(0); }
+
+  int Size() const { return size_; }
+
+  void PushBack(const Vector2d& v) {
+    Resize(size_ + 1);
+    Set(size_ - 1, v);
+  }
+
+  Vector2d Get(int index) const { return Vector2d(x_[index], y_[index]); }
+
+  void Set(int index, const Vector2d& v) {
+    x_[index] = v.x;
+    y_[index] = v.y;
+  }
+
+  float* X() { return x_.data(); }
+  const float* X() const { return x_.data(); }
+  float* Y() { return y_.data(); }
+  const float* Y() const { return y_.data(); }
+
+  /// this[i] += rhv[i]
+  void Add(const Vec2Array& rhv) {
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      store(i, load(x_, i) + load(rhv.x_, i), load(y_, i) + load(rhv.y_, i));
+    }
+  }
+
+  /// this[i] += v
+  void Add(const Vector2d& v) {
+    Simd::Float v_x = Simd::Float::Set(v.x);
+    Simd::Float v_y = Simd::Float::Set(v.y);
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      store(i, load(x_, i) + v_x, load(y_, i) + v_y);
+    }
+  }
+
+  /// this[i] += rhv[i] * scale, e.g. positions += velocities * dt.
+  void AddScaled(const Vec2Array& rhv, float scale) {
+    Simd::Float s = Simd::Float::Set(scale);
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      store(i, load(x_, i) + load(rhv.x_, i) * s,
+            load(y_, i) + load(rhv.y_, i) * s);
+    }
+  }
+
+  /// this[i] *= scale
+  void Scale(float scale) {
+    Simd::Float s = Simd::Float::Set(scale);
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      store(i, load(x_, i) * s, load(y_, i) * s);
+    }
+  }
+
+  /// result_out[i] = this[i] * rhv[i]
+  void Dot(const Vec2Array& rhv, std::vector<float>& result_out) const {
+    result_out.resize(x_.size());
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      Simd::Float dot =
+          load(x_, i) * load(rhv.x_, i) + load(y_, i) * load(rhv.y_, i);
+      dot.Store(&result_out[i]);
+    }
+    result_out.resize(size_);
+  }
+
+  void GetLengths(std::vector<float>& result_out) const {
+    result_out.resize(x_.size());
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      Simd::Float x = load(x_, i);
+      Simd::Float y = load(y_, i);
+      Simd::Sqrt(x * x + y * y).Store(&result_out[i]);
+    }
+    result_out.resize(size_);
+  }
+
+  /// Uses reciprocal square root estimate refined with one Newton-Raphson
+  /// step, relative error is about 1e-6. Zero vectors stay zero.
+  void Normalize() {
+    // Clamping keeps 0 * rsqrt(0) from producing NaN.
+    Simd::Float min_length_sq = Simd::Float::Set(1e-30f);
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      Simd::Float x = load(x_, i);
+      Simd::Float y = load(y_, i);
+      Simd::Float length_inv =
+          Simd::Rsqrt(Simd::Max(x * x + y * y, min_length_sq));
+      store(i, x * length_inv, y * length_inv);
+    }
+  }
+
+  /// Rotates every vector by the same angle, see Vector2d::Rotate.
+  void Rotate(float cos_val, float sin_val) {
+    Simd::Float c = Simd::Float::Set(cos_val);
+    Simd::Float s = Simd::Float::Set(sin_val);
+    for (int i = 0; i < (int)x_.size(); i += Simd::Float::kLanes) {
+      Simd::Float x = load(x_, i);
+      Simd::Float y = load(y_, i);
+      store(i, c * x - s * y, s * x + c * y);
+    }
+  }
+
+ private:
+  static int paddedSize(int size) {
+    const int kLanes = Simd::Float::kLanes;
+    return (size + kLanes - 1) / kLanes * kLanes;
+  }
+
+  static Simd::Float load(const Memory::AlignedVector<float>& values,
+                          int index) {
+    return Simd::Float::LoadAligned(&values[index]);
+  }
+
+  void store(int index, Simd::Float x, Simd::Float y) {
+    x.StoreAligned(&x_[index]);
+    y.StoreAligned(&y_[index]);
+  }
+
+  int size_{0};
+  Memory::AlignedVector<float> x_;
+  Memory::AlignedVector<float> y_;
+};
+}  // namespace Math
+}  // namespace Symphony
@@ -0,0 +1,91 @@
+#include "vec2_array.hpp"
+
+#include <gtest/gtest.h>
+
+#include "angle.hpp"
+
+using namespace Symphony::Math;
+
+namespace {
+// Not a multiple of any SIMD width.
+const int kSize = 37;
+
+Vec2Array MakeArray() {
+  Vec2Array result;
+  for (int i = 0; i < kSize; ++i) {
+    result.PushBack(Vector2d((float)i - 10.0f, 2.0f * (float)i + 1.0f));
+  }
+  return result;
+}
+}  // namespace
+
+TEST(Vec2Array, ResizeKeepsPaddingZero) {
+  Vec2Array a(3);
+  a.Add(Vector2d(1.0f, 1.0f));
+  a.Resize(5);
+  ASSERT_EQ(5, a.Size());
+  ASSERT_EQ(1.0f, a.Get(2).x);
+  ASSERT_EQ(0.0f, a.Get(3).x);
+  ASSERT_EQ(0.0f, a.Get(4).y);
+}
+
+TEST(Vec2Array, AddScale) {
+  Vec2Array a = MakeArray();
+  Vec2Array b = MakeArray();
+  a.Add(b);
+  a.Add(Vector2d(1.0f, -1.0f));
+  a.AddScaled(b, 0.5f);
+  a.Scale(2.0f);
+  for (int i = 0; i < kSize; ++i) {
+    Vector2d v = b.Get(i);
+    Vector2d expected = ((v + v + Vector2d(1.0f, -1.0f)) + v * 0.5f) * 2.0f;
+    ASSERT_NEAR(expected.x, a.Get(i).x, 0.0001f);
+    ASSERT_NEAR(expected.y, a.Get(i).y, 0.0001f);
+  }
+}
+
+TEST(Vec2Array, DotLengths) {
+  Vec2Array a = MakeArray();
+  Vec2Array b = MakeArray();
+  b.Rotate(cosf(DegToRad(30.0f)), sinf(DegToRad(30.0f)));
+
+  std::vector<float> dots;
+  a.Dot(b, dots);
+  std::vector<float> lengths;
+  a.GetLengths(lengths);
+  ASSERT_EQ(kSize, (int)dots.size());
+  ASSERT_EQ(kSize, (int)lengths.size());
+  for (int i = 0; i < kSize; ++i) {
+    ASSERT_NEAR(a.Get(i) * b.Get(i), dots[i], 0.01f);
+    ASSERT_NEAR(a.Get(i).GetLength(), lengths[i], 0.0001f);
+  }
+}
+
+TEST(Vec2Array, Rotate) {
+  Vec2Array a = MakeArray();
+  float angle = DegToRad(-75.0f);
+  a.Rotate(cosf(angle), sinf(angle));
+  Vec2Array b = MakeArray();
+  for (int i = 0; i < kSize; ++i) {
+    Vector2d expected = b.Get(i).GetRotated(angle);
+    ASSERT_NEAR(expected.x, a.Get(i).x, 0.0001f);
+    ASSERT_NEAR(expected.y, a.Get(i).y, 0.0001f);
+  }
+}
+
+TEST(Vec2Array, Normalize) {
+  Vec2Array a = MakeArray();
+  a.Set(5, Vector2d(0.0f, 0.0f));
+  a.Normalize();
+  Vec2Array b = MakeArray();
+  for (int i = 0; i < kSize; ++i) {
+    if (i == 5) {
+      ASSERT_EQ(0.0f, a.Get(i).x);
+      ASSERT_EQ(0.0f, a.Get(i).y);
+      continue;
+    }
+    Vector2d expected = b.Get(i).GetNormalized();
+    ASSERT_NEAR(expected.x, a.Get(i).x, 0.00001f);
+    ASSERT_NEAR(expected.y, a.Get(i).y, 0.00001f);
+  }
+}
@@ -4,44 +4,65 @@
 
 #include <format>
 #include <iostream>
+#include <type_traits>
+
+#include "fixed_point.hpp"
 
 namespace Symphony {
 namespace Math {
-class Vector2d {
+/// \arg Scalar float or Fixed.
+template <typename Scalar>
+class BasicVector2d {
  public:
-  Vector2d() : x(0.0f), y(0.0f) {}
+  constexpr BasicVector2d() : x(0), y(0) {}
 
-  Vector2d(float new_x, float new_y) : x(new_x), y(new_y) {}
+  constexpr BasicVector2d(Scalar new_x, Scalar new_y) : x(new_x), y(new_y) {}
 
-  static Vector2d Zero() { return Vector2d(0.0f, 0.0f); }
+  static constexpr BasicVector2d Zero() { return BasicVector2d(0, 0); }
 
-  static Vector2d X() { return Vector2d(1.0f, 0.0f); }
+  static constexpr BasicVector2d X() { return BasicVector2d(1, 0); }
 
-  static Vector2d Y() { return Vector2d(0.0f, 1.0f); }
+  static constexpr BasicVector2d Y() { return BasicVector2d(0, 1); }
 
-  Vector2d operator-() const { return Vector2d(-x, -y); }
+  constexpr BasicVector2d operator-() const { return BasicVector2d(-x, -y); }
 
-  Vector2d operator+(const Vector2d& rhv) const {
-    return Vector2d(x + rhv.x, y + rhv.y);
+  constexpr BasicVector2d operator+(const BasicVector2d& rhv) const {
+    return BasicVector2d(x + rhv.x, y + rhv.y);
   }
 
-  Vector2d operator-(const Vector2d& rhv) const {
-    return Vector2d(x - rhv.x, y - rhv.y);
+  constexpr BasicVector2d operator-(const BasicVector2d& rhv) const {
+    return BasicVector2d(x - rhv.x, y - rhv.y);
   }
 
-  Vector2d operator*(float v) const { return Vector2d(x * v, y * v); }
+  constexpr BasicVector2d operator*(Scalar v) const {
+    return BasicVector2d(x * v, y * v);
+  }
 
-  float operator*(const Vector2d& v) const { return x * v.x + y * v.y; }
+  constexpr Scalar operator*(const BasicVector2d& v) const {
+    return x * v.x + y * v.y;
+  }
 
-  float GetLengthSq() const { return x * x + y * y; }
+  constexpr Scalar GetLengthSq() const { return x * x + y * y; }
 
-  float GetLength() const { return sqrtf(GetLengthSq()); }
+  /// Dot product that doesn't overflow for Fixed, see MulWide.
+  constexpr auto DotWide(const BasicVector2d& v) const {
+    return MulWide(x, v.x) + MulWide(y, v.y);
+  }
 
-  void MakeNormalized(float eps) {
-    float l = GetLength();
+  /// z of the 3d cross product, see MulWide.
+  constexpr auto CrossWide(const BasicVector2d& v) const {
+    return MulWide(x, v.y) - MulWide(y, v.x);
+  }
+
+  constexpr auto GetLengthSqWide() const { return DotWide(*this); }
+
+  Scalar GetLength() const { return Hypot(x, y); }
+
+  void MakeNormalized(Scalar eps) {
+    Scalar l = GetLength();
     if (l < eps) {
-      x = 0.0f;
-      y = 0.0f;
+      x = 0;
+      y = 0;
     } else {
       x = x / l;
       y = y / l;
@@ -49,47 +70,57 @@ class Vector2d {
   }
 
   void MakeNormalized() {
-    float l = GetLength();
+    Scalar l = GetLength();
     x = x / l;
     y = y / l;
   }
 
-  Vector2d GetNormalized() const {
-    Vector2d v(x, y);
+  BasicVector2d GetNormalized() const {
+    BasicVector2d v(x, y);
     v.MakeNormalized();
     return v;
   }
 
-  void Rotate(float angle_rad) { Rotate(cosf(angle_rad), sinf(angle_rad)); }
+  /// Float only: libm sin and cos differ between platforms, Fixed vectors
+  /// take cos and sin from a deterministic source.
+  void Rotate(float angle_rad)
+    requires std::is_floating_point_v<Scalar>
+  {
+    Rotate(Scalar(cosf(angle_rad)), Scalar(sinf(angle_rad)));
+  }
 
-  Vector2d GetRotated(float angle_rad) const {
-    Vector2d v(x, y);
+  BasicVector2d GetRotated(float angle_rad) const
+    requires std::is_floating_point_v<Scalar>
+  {
+    BasicVector2d v(x, y);
     v.Rotate(angle_rad);
     return v;
   }
 
-  void Rotate(float cos_val, float sin_val) {
-    float new_x = cos_val * x - sin_val * y;
-    float new_y = sin_val * x + cos_val * y;
+  constexpr void Rotate(Scalar cos_val, Scalar sin_val) {
+    Scalar new_x = cos_val * x - sin_val * y;
+    Scalar new_y = sin_val * x + cos_val * y;
     x = new_x;
     y = new_y;
   }
 
-  Vector2d GetRotated(float cos_val, float sin_val) const {
-    Vector2d v(x, y);
+  constexpr BasicVector2d GetRotated(Scalar cos_val, Scalar sin_val) const {
+    BasicVector2d v(x, y);
     v.Rotate(cos_val, sin_val);
     return v;
   }
 
-  friend std::ostream& operator<<(std::ostream& os, const Vector2d& p) {
+  friend std::ostream& operator<<(std::ostream& os, const BasicVector2d& p) {
     os << "Vector2d(x: " << p.x << ", y: " << p.y << ")";
     return os;
   }
 
-  float x;
-  float y;
+  Scalar x;
+  Scalar y;
 };
 
+using Vector2d = BasicVector2d<float>;
+using FixedVector2d = BasicVector2d<Fixed>;
 }  // namespace Math
 }  // namespace Symphony
 